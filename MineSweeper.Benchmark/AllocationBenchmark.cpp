@@ -0,0 +1,124 @@
+﻿#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "Benchmark.h"
+#include "Game.h"
+#include "GameRenderer.h"
+#include "Solver.h"
+
+namespace
+{
+	// 下の operator new で数える、プログラム全体での確保の回数とバイト数
+	std::atomic<uint64_t> AllocationCount = 0;
+	std::atomic<uint64_t> AllocatedBytes = 0;
+}
+
+// ベンチマークのプログラム全体で置き換える（数えるだけで、確保は malloc に任せる）
+void* operator new(std::size_t size)
+{
+	AllocationCount.fetch_add(1, std::memory_order_relaxed);
+	AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	if (auto memory = std::malloc(size > 0 ? size : 1))
+		return memory;
+	throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace
+{
+	class NullRenderer : public GameRenderer
+	{
+	public:
+		void BeginFrame() override { }
+		void RenderCell(const Point&, const Cell&, bool) override { }
+		void RenderMineCounter(int32_t) override { }
+		void EndFrame() override { }
+	};
+
+	constexpr uint32_t Games = 32;
+
+	// play を Games 回実行して暖機した後、暖機とは別のシードで Games 回実行する間の確保の回数とバイト数を出力する
+	// pooled が true の行は確保が 1 回でもあれば NG とする
+	template <typename TPlay> void Measure(const char* name, const Size& size, double density, bool pooled, TPlay play)
+	{
+		for (uint32_t i = 0; i < Games; i++)
+			play(i);
+		const auto count = AllocationCount.load();
+		const auto bytes = AllocatedBytes.load();
+		Stopwatch stopwatch;
+		for (uint32_t i = 0; i < Games; i++)
+			play(Games + i);
+		const auto elapsed = stopwatch.GetElapsed();
+		const auto allocations = AllocationCount.load() - count;
+		std::printf("%-12s %6u %6u %7.1f%% %8u %12llu %14llu %12.3f %10s\n", name, size.Width, size.Height, density, Games,
+			static_cast<unsigned long long>(allocations), static_cast<unsigned long long>(AllocatedBytes.load() - bytes), ToMilliseconds(elapsed) / Games,
+			!pooled ? "-" : allocations == 0 ? "ok" : "NG");
+	}
+
+	// 1 回の対局を想定し、記録を有効にして開く・旗を切り替える・周囲を開く・取り消す・描画するを行う
+	void PlayRound(Game& game, const Point& first)
+	{
+		NullRenderer renderer;
+		game.SetIsHistoryEnabled(true);
+		game.Render(renderer);
+		game.OpenCell(first);
+		for (const auto& loc : AllPointView(game.GetSize()))
+		{
+			if (game.GetCell(loc).State == CellState::Closed)
+			{
+				game.SwitchFlaggedState(loc);
+				break;
+			}
+		}
+		game.OpenCellsWithMineIndicator(first);
+		game.Render(renderer);
+		game.Undo();
+		game.Redo();
+		game.Render(renderer);
+	}
+
+	void RunSize(const Size& size, double density)
+	{
+		const auto mines = static_cast<uint32_t>(static_cast<double>(size.Width) * size.Height * density / 100);
+		const Point first(size.Width / 2, size.Height / 2);
+		// 対局ごとに Game を作り直す（破棄した Game の領域は次の Game で再利用される）
+		Measure("construct", size, density, true, [&](uint32_t i)
+			{
+				Game game(size, mines, i);
+				PlayRound(game, first);
+			});
+		// 比較として、再利用する領域を毎回解放してから Game を作る
+		Measure("unpooled", size, density, false, [&](uint32_t i)
+			{
+				Game::ClearBufferPool();
+				Game game(size, mines, i);
+				PlayRound(game, first);
+			});
+		// シミュレーションと同じく Game と Solver を作り直さずに Reset で始め直し、推論だけで解けるところまで解く
+		Game game(size, mines, 0);
+		Solver solver(game);
+		Measure("reset", size, density, true, [&](uint32_t i)
+			{
+				game.Reset(i);
+				game.PlaceMines(first);
+				solver.Reset();
+				solver.Open(first);
+				solver.Solve();
+			});
+	}
+}
+
+void RunAllocationBenchmark()
+{
+	std::printf("%-12s %6s %6s %8s %8s %12s %14s %12s %10s\n", "benchmark", "width", "height", "density", "games", "allocs", "bytes", "ms/game", "no-alloc");
+	RunSize(Size(30, 16), 20.6);
+	RunSize(Size(1000, 1000), 1.0);
+	RunSize(Size(1000, 1000), 15.0);
+	Game::ClearBufferPool();
+}
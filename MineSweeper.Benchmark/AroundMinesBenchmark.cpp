@@ -0,0 +1,48 @@
+﻿#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "AroundMines.h"
+#include "Benchmark.h"
+
+namespace
+{
+	struct AroundMinesBoard
+	{
+		std::vector<Cell> Cells;
+		std::vector<size_t> MineIndices;
+	};
+
+	AroundMinesBoard CreateBoard(const Size& size, uint32_t mines, std::mt19937& rng)
+	{
+		AroundMinesBoard board;
+		board.Cells.resize(static_cast<size_t>(size.Width) * size.Height);
+		std::vector<size_t> indices(board.Cells.size());
+		std::iota(indices.begin(), indices.end(), size_t(0));
+		std::shuffle(indices.begin(), indices.end(), rng);
+		board.MineIndices.assign(indices.begin(), indices.begin() + mines);
+		for (auto index : board.MineIndices)
+			board.Cells[index].HasMine = true;
+		return board;
+	}
+}
+
+void RunAroundMinesBenchmark()
+{
+	constexpr Size size(1000, 1000);
+	constexpr uint32_t densities[] = { 1, 5, 10, 12, 15, 20, 25, 50, 90 };
+	std::mt19937 rng(12345);
+	std::printf("%-12s %6s %6s %8s %10s %12s %12s\n", "benchmark", "width", "height", "density", "mines", "scatter[ms]", "rowsum[ms]");
+	for (auto density : densities)
+	{
+		const auto mines = static_cast<uint32_t>(static_cast<uint64_t>(size.Width) * size.Height * density / 100);
+		const auto board = CreateBoard(size, mines, rng);
+		const auto scatter = MeasureMinimum(5,
+			[&]() { return board; },
+			[&](AroundMinesBoard& target) { CountAroundMinesByScatter(target.Cells, size, target.MineIndices); });
+		const auto rowSum = MeasureMinimum(5,
+			[&]() { return board; },
+			[&](AroundMinesBoard& target) { CountAroundMinesByRowSum(target.Cells, size); });
+		std::printf("%-12s %6u %6u %7u%% %10u %12.3f %12.3f\n", "aroundmines", size.Width, size.Height, density, mines, ToMilliseconds(scatter), ToMilliseconds(rowSum));
+	}
+}
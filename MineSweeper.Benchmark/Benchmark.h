@@ -0,0 +1,53 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+class Stopwatch
+{
+public:
+	Stopwatch() : m_Start(std::chrono::steady_clock::now()) { }
+
+	void Restart() { m_Start = std::chrono::steady_clock::now(); }
+	std::chrono::nanoseconds GetElapsed() const { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_Start); }
+
+private:
+	std::chrono::steady_clock::time_point m_Start;
+};
+
+// setup で用意した状態に対して action を repeats 回実行し、最も速かった回の所要時間を返す（setup は計測に含めない）
+template <typename TSetup, typename TAction> std::chrono::nanoseconds MeasureMinimum(uint32_t repeats, TSetup setup, TAction action)
+{
+	auto best = std::chrono::nanoseconds::max();
+	for (uint32_t i = 0; i < repeats; i++)
+	{
+		auto state = setup();
+		Stopwatch stopwatch;
+		action(state);
+		best = std::min(best, stopwatch.GetElapsed());
+	}
+	return best;
+}
+
+constexpr double ToMilliseconds(std::chrono::nanoseconds value) { return std::chrono::duration<double, std::milli>(value).count(); }
+
+void RunPlacementBenchmark();
+void RunAroundMinesBenchmark();
+void RunFloodFillBenchmark();
+void RunBitBoardBenchmark();
+void RunSolverBenchmark();
+void RunProbabilityBenchmark();
+void RunNoGuessBenchmark();
+void RunReplayBenchmark();
+void RunSnapshotBenchmark();
+void RunHistoryBenchmark();
+// operator new を置き換えて確保の回数を数え、同じゲームの列を繰り返したときに盤面と作業用の領域の再利用で確保が起きないかを調べる
+void RunAllocationBenchmark();
+// GameServer に多数のセッションから要求を送り続け、処理できた要求の数と応答までの時間の分布を計測する
+void RunServerBenchmark();
+// MemoryInputConsole で用意した操作で PlayGame を画面なしで実行し、描画の速さと MemoryOutputConsole に残った画面を調べる
+void RunConsoleBenchmark();
+// 盤面の大きさと地雷の密度の組み合わせごとに Game の主な操作を計測し、format (csv または json) の形式で出力する
+bool RunSuiteBenchmark(std::string_view format);
@@ -0,0 +1,82 @@
+﻿#include <cstdio>
+#include <random>
+#include <vector>
+#include "AroundMines.h"
+#include "Benchmark.h"
+#include "BitBoard.h"
+
+namespace
+{
+	// 以前の Game と同じく 1 セル 1 バイトの Cell を走査する実装
+	int32_t CountUnflaggedMinesByScan(std::span<const Cell> cells)
+	{
+		int32_t mines = 0;
+		int32_t flags = 0;
+		for (const auto& cell : cells)
+		{
+			if (cell.HasMine)
+				mines++;
+			if (cell.State == CellState::Flagged)
+				flags++;
+		}
+		return mines - flags;
+	}
+	GameProgress GetProgressByScan(std::span<const Cell> cells)
+	{
+		GameProgress result = GameProgress::Completed;
+		for (const auto& cell : cells)
+		{
+			if (cell.HasMine && cell.State == CellState::Open)
+				return GameProgress::Failed;
+			if (!cell.HasMine && cell.State != CellState::Open)
+				result = GameProgress::InProgress;
+		}
+		return result;
+	}
+	void OpenAllMinesByScan(std::span<Cell> cells)
+	{
+		for (auto& cell : cells)
+		{
+			if (cell.HasMine)
+				cell.State = CellState::Open;
+		}
+	}
+
+	void Report(const char* operation, const Size& size, std::chrono::nanoseconds cells, std::chrono::nanoseconds bits)
+	{
+		std::printf("%-12s %-18s %6u %6u %12.3f %12.3f %8.1fx\n", "bitboard", operation, size.Width, size.Height, ToMilliseconds(cells), ToMilliseconds(bits),
+			static_cast<double>(cells.count()) / static_cast<double>(bits.count()));
+	}
+}
+
+void RunBitBoardBenchmark()
+{
+	constexpr Size size(4096, 4096);
+	const size_t count = static_cast<size_t>(size.Width) * size.Height;
+	std::mt19937 rng(12345);
+	std::bernoulli_distribution mine(0.15);
+	std::bernoulli_distribution open(0.5);
+	std::bernoulli_distribution flag(0.05);
+	std::vector<Cell> cells(count);
+	for (auto& cell : cells)
+	{
+		cell.HasMine = mine(rng);
+		cell.State = !cell.HasMine && open(rng) ? CellState::Open : flag(rng) ? CellState::Flagged : CellState::Closed;
+	}
+	BitBoard board(size, cells);
+
+	std::printf("%-12s %-18s %6s %6s %12s %12s %9s\n", "benchmark", "operation", "width", "height", "cell[ms]", "bitboard[ms]", "speedup");
+	volatile int64_t sink = 0;
+	Report("unflaggedmines", size,
+		MeasureMinimum(5, [] { return 0; }, [&](int) { sink = CountUnflaggedMinesByScan(cells); }),
+		MeasureMinimum(5, [] { return 0; }, [&](int) { sink = board.CountUnflaggedMines(); }));
+	Report("progress", size,
+		MeasureMinimum(5, [] { return 0; }, [&](int) { sink = static_cast<int64_t>(GetProgressByScan(cells)); }),
+		MeasureMinimum(5, [] { return 0; }, [&](int) { sink = static_cast<int64_t>(board.GetProgress()); }));
+	Report("openallmines", size,
+		MeasureMinimum(5, [&] { return cells; }, [](std::vector<Cell>& target) { OpenAllMinesByScan(target); }),
+		MeasureMinimum(5, [&] { return board; }, [](BitBoard& target) { target.OpenAllMines(); }));
+	Report("aroundmines", size,
+		MeasureMinimum(5, [&] { return cells; }, [&](std::vector<Cell>& target) { CountAroundMinesByRowSum(target, size); }),
+		MeasureMinimum(5, [] { return 0; }, [&](int) { board.UpdateAroundMines(); }));
+}
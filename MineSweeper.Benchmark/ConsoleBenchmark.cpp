@@ -0,0 +1,209 @@
+﻿#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include "Benchmark.h"
+#include "Game.h"
+#include "GameRecord.h"
+#include "MemoryConsole.h"
+#include "PlayGame.h"
+
+namespace
+{
+	constexpr MouseButtonState LeftButton(0x0001);
+	constexpr MouseButtonState RightButton(0x0002);
+
+	MouseEventRecord CreateMouseEvent(MouseEventKind kind, ConsoleCoordinate location, MouseButtonState buttonState, int16_t delta = 0)
+	{
+		MouseEventRecord record;
+		record.Kind = kind;
+		record.Location = location;
+		record.ButtonState = buttonState;
+		record.Delta = delta;
+		return record;
+	}
+	// 1 回のクリックを押下と解放の 2 つのイベントからなる 1 まとまりの入力として追加する
+	void AddClick(MemoryInputConsole& input, const Point& loc, MouseButtonState button)
+	{
+		const ConsoleCoordinate location(static_cast<int16_t>(loc.X * 2), static_cast<int16_t>(loc.Y));
+		input.AddInput({ CreateMouseEvent(MouseEventKind::PressedOrReleased, location, button), CreateMouseEvent(MouseEventKind::PressedOrReleased, location, MouseButtonState()) });
+	}
+	void AddKey(MemoryInputConsole& input, uint16_t virtualKeyCode)
+	{
+		KeyEventRecord record;
+		record.IsKeyDown = true;
+		record.RepeatCount = 1;
+		record.VirtualKeyCode = virtualKeyCode;
+		input.AddInput(record);
+	}
+	ConsoleSize GetScreenBufferSize(const Size& viewportSize) { return ConsoleSize(static_cast<int16_t>(std::max<uint32_t>(80, viewportSize.Width * 2)), static_cast<int16_t>(viewportSize.Height + 1)); }
+
+	// 画面に残った最後のフレームが表示範囲の盤面の状態と一致するかを調べる
+	bool VerifyScreen(const Game& game, const Rect& viewport, const MemoryOutputConsole& output)
+	{
+		const auto& screen = output.GetScreen();
+		for (const auto& loc : AllPointView(viewport.GetSize()))
+		{
+			const auto& cell = game.GetCell(Point(viewport.X + loc.X, viewport.Y + loc.Y));
+			const auto character = screen.GetCharacter(ConsoleCoordinate(static_cast<int16_t>(loc.X * 2), static_cast<int16_t>(loc.Y)));
+			wchar_t expected;
+			if (cell.State == CellState::Flagged || cell.State != CellState::Open)
+				expected = L'■';
+			else if (cell.HasMine)
+				expected = L'●';
+			else if (cell.AroundMines == 0)
+				expected = L' ';
+			else
+				expected = static_cast<wchar_t>(L'０' + cell.AroundMines);
+			if (character != expected)
+				return false;
+		}
+		return screen.GetText(static_cast<int16_t>(viewport.Height)).starts_with(L"残り地雷数: " + std::to_wstring(game.CountUnflaggedMines()));
+	}
+
+	// すべての地雷に旗を立ててから、安全なセルを行優先の順にすべて開くまで PlayGame を実行する
+	void RunPlay(const Size& size, uint32_t mines)
+	{
+		const Point center(size.Width / 2, size.Height / 2);
+		bool verified = false;
+		uint64_t frames = 0;
+		uint64_t calls = 0;
+		uint64_t flushes = 0;
+		const auto time = MeasureMinimum(5,
+			[&]()
+			{
+				Game game(size, mines, 1);
+				game.PlaceMines(center);
+				auto input = std::make_unique<MemoryInputConsole>();
+				for (const auto& loc : AllPointView(size))
+				{
+					if (game.GetCell(loc).HasMine)
+						AddClick(*input, loc, RightButton);
+				}
+				for (const auto& loc : AllPointView(size))
+				{
+					if (!game.GetCell(loc).HasMine)
+						AddClick(*input, loc, LeftButton);
+				}
+				return std::make_tuple(std::move(game), std::move(input), std::make_unique<MemoryOutputConsole>(GetScreenBufferSize(GetViewportSize(size))));
+			},
+			[&](auto& state)
+			{
+				auto& [game, input, output] = state;
+				GameRecord record(size, mines, game.GetSeed());
+				InputLatency latency;
+				const bool completed = PlayGame(game, false, record, latency, *input, *output);
+				verified = completed && VerifyScreen(game, Rect(Point(), GetViewportSize(size)), *output);
+				frames = latency.Frames;
+				calls = output->GetNumberOfCalls();
+				flushes = output->GetNumberOfFlushes();
+			});
+		std::printf("%-12s %6u %6u %8u %8llu %10.3f %12.0f %10.2f %10s\n", "play", size.Width, size.Height, mines,
+			static_cast<unsigned long long>(frames), ToMilliseconds(time), static_cast<double>(frames) / std::chrono::duration<double>(time).count(),
+			static_cast<double>(calls) / static_cast<double>(flushes), verified ? "ok" : "NG");
+	}
+	// 最大の表示範囲を持つ広い盤面で、ホイールによる縦横の移動を 1 イベントずつ描画する
+	void RunScroll(const Size& size, uint32_t mines)
+	{
+		constexpr uint32_t Steps = 2000;
+		const Point center(size.Width / 2, size.Height / 2);
+		Rect viewport;
+		bool verified = false;
+		uint64_t frames = 0;
+		uint64_t calls = 0;
+		uint64_t flushes = 0;
+		const auto time = MeasureMinimum(5,
+			[&]()
+			{
+				Game game(size, mines, 1);
+				game.PlaceMines(center);
+				game.OpenCell(center);
+				auto input = std::make_unique<MemoryInputConsole>();
+				// 下と右へ 100 回ずつ進んでから戻る動きを繰り返す
+				viewport = Rect(Point(), GetViewportSize(size));
+				for (uint32_t i = 0; i < Steps; i++)
+				{
+					const bool vertical = i % 2 == 0;
+					const int16_t delta = i / 2 % 200 < 100 ? -120 : 120;
+					input->AddInput(CreateMouseEvent(vertical ? MouseEventKind::VerticallyWheeled : MouseEventKind::HorizontallyWheeled, ConsoleCoordinate(), MouseButtonState(), delta));
+					const int32_t amount = delta > 0 ? -WheelScrollAmount : WheelScrollAmount;
+					if (vertical)
+						viewport.Y = static_cast<uint32_t>(std::clamp<int64_t>(static_cast<int64_t>(viewport.Y) + amount, 0, size.Height - viewport.Height));
+					else
+						viewport.X = static_cast<uint32_t>(std::clamp<int64_t>(static_cast<int64_t>(viewport.X) - amount, 0, size.Width - viewport.Width));
+				}
+				return std::make_tuple(std::move(game), std::move(input), std::make_unique<MemoryOutputConsole>(GetScreenBufferSize(GetViewportSize(size))));
+			},
+			[&](auto& state)
+			{
+				auto& [game, input, output] = state;
+				GameRecord record(size, mines, game.GetSeed());
+				InputLatency latency;
+				try
+				{
+					PlayGame(game, false, record, latency, *input, *output);
+				}
+				catch (const std::out_of_range&)
+				{
+					// 用意した入力を使い切ったところで終える（最後のイベントによる変化は描画済み）
+				}
+				verified = input->IsEmpty() && VerifyScreen(game, viewport, *output);
+				frames = latency.Frames;
+				calls = output->GetNumberOfCalls();
+				flushes = output->GetNumberOfFlushes();
+			});
+		std::printf("%-12s %6u %6u %8u %8llu %10.3f %12.0f %10.2f %10s\n", "scroll", size.Width, size.Height, mines,
+			static_cast<unsigned long long>(frames), ToMilliseconds(time), static_cast<double>(frames) / std::chrono::duration<double>(time).count(),
+			static_cast<double>(calls) / static_cast<double>(flushes), verified ? "ok" : "NG");
+	}
+	// 最初に開いたセルを [Z] で取り消して別のセルを開き、保存した記録の再生が同じ盤面になるかを調べる
+	void RunUndoReplay(const Size& size, uint32_t mines)
+	{
+		const Point first(0, 0);
+		const Point second(size.Width - 1, size.Height - 1);
+		Game game(size, mines, 1);
+		auto input = std::make_unique<MemoryInputConsole>();
+		AddClick(*input, first, LeftButton);
+		AddKey(*input, 'Z');
+		AddClick(*input, second, LeftButton);
+		auto output = std::make_unique<MemoryOutputConsole>(GetScreenBufferSize(GetViewportSize(size)));
+		GameRecord record(size, mines, game.GetSeed());
+		InputLatency latency;
+		Stopwatch stopwatch;
+		try
+		{
+			PlayGame(game, false, record, latency, *input, *output);
+		}
+		catch (const std::out_of_range&)
+		{
+			// 用意した入力を使い切ったところで終える
+		}
+		const auto time = stopwatch.GetElapsed();
+		record.SetSeed(game.GetSeed());
+		Game replayed(size, mines);
+		GameRecord::Deserialize(record.Serialize()).Replay(replayed);
+		bool verified = input->IsEmpty() && replayed.GetProgress() == game.GetProgress();
+		for (size_t i = 0; i < game.GetCells().size(); i++)
+		{
+			const auto& expected = game.GetCells()[i];
+			const auto& actual = replayed.GetCells()[i];
+			if (actual.HasMine != expected.HasMine || actual.AroundMines != expected.AroundMines || actual.State != expected.State)
+				verified = false;
+		}
+		std::printf("%-12s %6u %6u %8u %8llu %10.3f %12s %10.2f %10s\n", "undoreplay", size.Width, size.Height, mines,
+			static_cast<unsigned long long>(latency.Frames), ToMilliseconds(time), "-",
+			static_cast<double>(output->GetNumberOfCalls()) / static_cast<double>(output->GetNumberOfFlushes()), verified ? "ok" : "NG");
+	}
+}
+
+void RunConsoleBenchmark()
+{
+	std::printf("%-12s %6s %6s %8s %8s %10s %12s %10s %10s\n", "benchmark", "width", "height", "mines", "frames", "time[ms]", "frames/s", "calls/frm", "verified");
+	RunPlay(Size(9, 9), 10);
+	RunPlay(Size(30, 16), 99);
+	RunPlay(Size(60, 40), 480);
+	RunScroll(Size(1000, 1000), 150000);
+	RunUndoReplay(Size(30, 16), 99);
+}
@@ -0,0 +1,25 @@
+﻿#include <cstdio>
+#include "Benchmark.h"
+#include "Game.h"
+
+void RunFloodFillBenchmark()
+{
+	constexpr Size size(1000, 1000);
+	constexpr double densities[] = { 0.0, 0.5, 1.0, 2.0, 5.0 };
+	std::printf("%-12s %6s %6s %8s %10s %10s %12s\n", "benchmark", "width", "height", "density", "mines", "opened", "time[ms]");
+	for (auto density : densities)
+	{
+		const auto mines = static_cast<uint32_t>(static_cast<double>(size.Width) * size.Height * density / 100);
+		const Point center(size.Width / 2, size.Height / 2);
+		size_t opened = 0;
+		const auto time = MeasureMinimum(5,
+			[&]()
+			{
+				Game game(size, mines);
+				game.PlaceMines(center);
+				return game;
+			},
+			[&](Game& game) { opened = game.OpenCell(center); });
+		std::printf("%-12s %6u %6u %7.1f%% %10u %10zu %12.3f\n", "floodfill", size.Width, size.Height, density, mines, opened, ToMilliseconds(time));
+	}
+}
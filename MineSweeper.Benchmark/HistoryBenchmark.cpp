@@ -0,0 +1,101 @@
+﻿#include <cstdio>
+#include <vector>
+#include "Benchmark.h"
+#include "Game.h"
+
+namespace
+{
+	Game CreateGame(const Size& size, uint32_t mines, bool history)
+	{
+		Game game(size, mines, 1);
+		game.PlaceMines(Point(size.Width / 2, size.Height / 2));
+		game.SetIsHistoryEnabled(history);
+		return game;
+	}
+
+	// 中央を開く 1 回の大きな操作について、記録の有無による差と取り消し・やり直しの時間を計測する
+	void RunFloodFill(const Size& size, double density)
+	{
+		const auto mines = static_cast<uint32_t>(static_cast<double>(size.Width) * size.Height * density / 100);
+		const Point center(size.Width / 2, size.Height / 2);
+		size_t opened = 0;
+		const auto open = MeasureMinimum(5, [&]() { return CreateGame(size, mines, false); }, [&](Game& game) { opened = game.OpenCell(center); });
+		const auto record = MeasureMinimum(5, [&]() { return CreateGame(size, mines, true); }, [&](Game& game) { game.OpenCell(center); });
+		const auto openedGame = [&]()
+		{
+			auto game = CreateGame(size, mines, true);
+			game.OpenCell(center);
+			return game;
+		};
+		const auto undo = MeasureMinimum(5, openedGame, [](Game& game) { game.Undo(); });
+		const auto redo = MeasureMinimum(5,
+			[&]()
+			{
+				auto game = openedGame();
+				game.Undo();
+				return game;
+			},
+			[](Game& game) { game.Redo(); });
+		const auto game = openedGame();
+		std::printf("%-12s %6u %6u %7.1f%% %10zu %10zu %10zu %10.3f %10.3f %10.3f %10.3f\n", "floodfill", size.Width, size.Height, density, opened,
+			game.GetHistory().GetRuns(0).size(), game.GetHistory().GetMemoryUsage(), ToMilliseconds(open), ToMilliseconds(record), ToMilliseconds(undo), ToMilliseconds(redo));
+	}
+
+	// 探索の分岐を想定し、閉じたセルを 1 つ開いてから開く前に戻すことを繰り返す
+	// 比較として、分岐のたびにセルの配列を複製する場合の複製と開く時間を計測する（複製から戻す時間は含まない）
+	void RunBranch(const Size& size, double density)
+	{
+		constexpr uint32_t Branches = 1000;
+		const auto mines = static_cast<uint32_t>(static_cast<double>(size.Width) * size.Height * density / 100);
+		const Point center(size.Width / 2, size.Height / 2);
+		const auto setup = [&]()
+		{
+			auto game = CreateGame(size, mines, true);
+			game.OpenCell(center);
+			return game;
+		};
+		std::vector<Point> targets;
+		{
+			const auto game = setup();
+			for (const auto& loc : AllPointView(size))
+			{
+				if (game.GetCell(loc).State == CellState::Closed && !game.GetCell(loc).HasMine && targets.size() < Branches)
+					targets.emplace_back(loc);
+			}
+		}
+		size_t opened = 0;
+		const auto rewind = MeasureMinimum(5, setup,
+			[&](Game& game)
+			{
+				opened = 0;
+				const auto position = game.GetHistoryPosition();
+				for (const auto& loc : targets)
+				{
+					opened += game.OpenCell(loc);
+					game.RewindHistory(position);
+				}
+			});
+		const auto copy = MeasureMinimum(5, setup,
+			[&](Game& game)
+			{
+				for (const auto& loc : targets)
+				{
+					const std::vector<Cell> cells(game.GetCells().begin(), game.GetCells().end());
+					static_cast<void>(cells);
+					game.OpenCell(loc);
+				}
+			});
+		std::printf("%-12s %6u %6u %7.1f%% %10zu %10zu %10.3f %10.3f\n", "branch", size.Width, size.Height, density, targets.size(), opened, ToMilliseconds(rewind), ToMilliseconds(copy));
+	}
+}
+
+void RunHistoryBenchmark()
+{
+	std::printf("%-12s %6s %6s %8s %10s %10s %10s %10s %10s %10s %10s\n", "benchmark", "width", "height", "density", "opened", "runs", "bytes", "open[ms]", "record[ms]", "undo[ms]", "redo[ms]");
+	constexpr Size size(1000, 1000);
+	constexpr double densities[] = { 0.0, 1.0, 5.0 };
+	for (auto density : densities)
+		RunFloodFill(size, density);
+	std::printf("%-12s %6s %6s %8s %10s %10s %10s %10s\n", "benchmark", "width", "height", "density", "branches", "opened", "rewind[ms]", "copy[ms]");
+	RunBranch(size, 15.0);
+}
@@ -0,0 +1,91 @@
+﻿#include <cstdio>
+#include <string_view>
+#include "Benchmark.h"
+
+int main(int argc, char* argv[])
+{
+	const std::string_view name = argc > 1 ? argv[1] : "all";
+	// 機械で読み取る形式で出力するため、all には含めない
+	if (name == "suite")
+	{
+		const std::string_view format = argc > 2 ? argv[2] : "csv";
+		if (!RunSuiteBenchmark(format))
+		{
+			std::fprintf(stderr, "Unknown format: %.*s\n", static_cast<int>(format.size()), format.data());
+			return 1;
+		}
+		return 0;
+	}
+	bool found = false;
+	if (name == "all" || name == "placement")
+	{
+		RunPlacementBenchmark();
+		found = true;
+	}
+	if (name == "all" || name == "aroundmines")
+	{
+		RunAroundMinesBenchmark();
+		found = true;
+	}
+	if (name == "all" || name == "floodfill")
+	{
+		RunFloodFillBenchmark();
+		found = true;
+	}
+	if (name == "all" || name == "bitboard")
+	{
+		RunBitBoardBenchmark();
+		found = true;
+	}
+	if (name == "all" || name == "solver")
+	{
+		RunSolverBenchmark();
+		found = true;
+	}
+	if (name == "all" || name == "probability")
+	{
+		RunProbabilityBenchmark();
+		found = true;
+	}
+	if (name == "all" || name == "noguess")
+	{
+		RunNoGuessBenchmark();
+		found = true;
+	}
+	if (name == "all" || name == "replay")
+	{
+		RunReplayBenchmark();
+		found = true;
+	}
+	if (name == "all" || name == "snapshot")
+	{
+		RunSnapshotBenchmark();
+		found = true;
+	}
+	if (name == "all" || name == "history")
+	{
+		RunHistoryBenchmark();
+		found = true;
+	}
+	if (name == "all" || name == "allocation")
+	{
+		RunAllocationBenchmark();
+		found = true;
+	}
+	if (name == "all" || name == "server")
+	{
+		RunServerBenchmark();
+		found = true;
+	}
+	if (name == "all" || name == "console")
+	{
+		RunConsoleBenchmark();
+		found = true;
+	}
+	if (!found)
+	{
+		std::fprintf(stderr, "Unknown benchmark: %.*s\n", static_cast<int>(name.size()), name.data());
+		return 1;
+	}
+	return 0;
+}
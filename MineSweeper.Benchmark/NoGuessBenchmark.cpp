@@ -0,0 +1,36 @@
+﻿#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include "Benchmark.h"
+#include "Game.h"
+#include "NoGuessGenerator.h"
+
+void RunNoGuessBenchmark()
+{
+	struct Level
+	{
+		::Size Size;
+		uint32_t Mines;
+	};
+	constexpr Level levels[] = { { { 9, 9 }, 10 }, { { 16, 16 }, 40 }, { { 30, 16 }, 99 } };
+	constexpr uint32_t boards = 100;
+	std::printf("%-12s %6s %6s %10s %8s %8s %12s %12s\n", "benchmark", "width", "height", "mines", "boards", "found", "mean[ms]", "max[ms]");
+	for (const auto& level : levels)
+	{
+		const Point first(level.Size.Width / 2, level.Size.Height / 2);
+		uint32_t found = 0;
+		std::chrono::nanoseconds total(0);
+		std::chrono::nanoseconds slowest(0);
+		for (uint32_t i = 0; i < boards; i++)
+		{
+			Game game(level.Size, level.Mines);
+			Stopwatch stopwatch;
+			if (PlaceMinesWithoutGuessing(game, first))
+				found++;
+			const auto time = stopwatch.GetElapsed();
+			total += time;
+			slowest = std::max(slowest, time);
+		}
+		std::printf("%-12s %6u %6u %10u %8u %8u %12.3f %12.3f\n", "noguess", level.Size.Width, level.Size.Height, level.Mines, boards, found, ToMilliseconds(total) / boards, ToMilliseconds(slowest));
+	}
+}
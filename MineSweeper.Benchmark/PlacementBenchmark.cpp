@@ -0,0 +1,23 @@
+﻿#include <cstdio>
+#include "Benchmark.h"
+#include "Game.h"
+
+void RunPlacementBenchmark()
+{
+	constexpr Size sizes[] = { { 30, 16 }, { 1000, 1000 } };
+	constexpr uint32_t densities[] = { 1, 5, 10, 25, 50, 75, 90, 95, 99 };
+	std::printf("%-12s %6s %6s %8s %10s %12s\n", "benchmark", "width", "height", "density", "mines", "time[ms]");
+	for (const auto& size : sizes)
+	{
+		const uint64_t cells = static_cast<uint64_t>(size.Width) * size.Height;
+		const uint32_t repeats = cells > 100000 ? 5 : 200;
+		for (auto density : densities)
+		{
+			const auto mines = static_cast<uint32_t>(std::min(cells * density / 100, cells - 1));
+			const auto time = MeasureMinimum(repeats,
+				[&]() { return Game(size, mines); },
+				[&](Game& game) { game.PlaceMines(Point(size.Width / 2, size.Height / 2)); });
+			std::printf("%-12s %6u %6u %7u%% %10u %12.3f\n", "placement", size.Width, size.Height, density, mines, ToMilliseconds(time));
+		}
+	}
+}
@@ -0,0 +1,49 @@
+﻿#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "Benchmark.h"
+#include "Game.h"
+#include "MineProbability.h"
+#include "Solver.h"
+
+void RunProbabilityBenchmark()
+{
+	struct Level
+	{
+		::Size Size;
+		uint32_t Mines;
+	};
+	constexpr Level levels[] = { { { 30, 16 }, 99 }, { { 100, 100 }, 2000 }, { { 1000, 1000 }, 150000 } };
+	std::vector<uint32_t> threadCounts { 1 };
+	if (std::thread::hardware_concurrency() > 1)
+		threadCounts.emplace_back(std::thread::hardware_concurrency());
+	std::printf("%-12s %6s %6s %10s %8s %8s %8s %12s\n", "benchmark", "width", "height", "mines", "threads", "boards", "exact", "time[ms]");
+	for (const auto& level : levels)
+	{
+		const uint64_t cells = static_cast<uint64_t>(level.Size.Width) * level.Size.Height;
+		const uint32_t boards = cells > 100000 ? 3 : 200;
+		const Point first(level.Size.Width / 2, level.Size.Height / 2);
+		for (auto threads : threadCounts)
+		{
+			ProbabilityOptions options;
+			options.Threads = threads;
+			uint32_t exact = 0;
+			std::chrono::nanoseconds total(0);
+			for (uint32_t i = 0; i < boards; i++)
+			{
+				// 推論だけでは進めなくなった局面の確率を求める
+				Game game(level.Size, level.Mines);
+				Solver solver(game);
+				solver.Open(first);
+				solver.Solve();
+				Stopwatch stopwatch;
+				const auto probabilities = CalculateMineProbabilities(game, options);
+				total += stopwatch.GetElapsed();
+				if (probabilities.IsExact())
+					exact++;
+			}
+			std::printf("%-12s %6u %6u %10u %8u %8u %8u %12.3f\n", "probability", level.Size.Width, level.Size.Height, level.Mines, threads, boards, exact, ToMilliseconds(total) / boards);
+		}
+	}
+}
@@ -0,0 +1,69 @@
+﻿#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "Benchmark.h"
+#include "Game.h"
+#include "GameRecord.h"
+#include "Random.h"
+
+namespace
+{
+	// 地雷のないセルを無作為な順に開き、ときどき地雷に旗を立てるプレイヤーの記録を作る
+	GameRecord CreateRecord(const Size& size, uint32_t mines, uint64_t seed)
+	{
+		Game game(size, mines, seed);
+		GameRecord record(size, mines, seed);
+		Random random(seed);
+		std::chrono::milliseconds time(0);
+		while (game.GetProgress() == GameProgress::InProgress)
+		{
+			const Point loc(static_cast<uint32_t>(random.NextBelow(size.Width)), static_cast<uint32_t>(random.NextBelow(size.Height)));
+			const auto& cell = game.GetCell(loc);
+			if (cell.State != CellState::Closed || (game.HasPlacedMines() && cell.HasMine && random.NextBelow(4) != 0))
+				continue;
+			time += std::chrono::milliseconds(200 + random.NextBelow(800));
+			const auto kind = cell.HasMine ? GameActionKind::SwitchFlag : GameActionKind::Open;
+			if (kind == GameActionKind::Open)
+				game.OpenCell(loc);
+			else
+				game.SwitchFlaggedState(loc);
+			record.AddAction(GameAction(kind, loc, time));
+		}
+		return record;
+	}
+}
+
+void RunReplayBenchmark()
+{
+	struct Level
+	{
+		::Size Size;
+		uint32_t Mines;
+	};
+	constexpr Level levels[] = { { { 9, 9 }, 10 }, { { 16, 16 }, 40 }, { { 30, 16 }, 99 } };
+	constexpr uint32_t records = 1000;
+	std::printf("%-12s %6s %6s %10s %8s %10s %12s %12s %12s\n", "benchmark", "width", "height", "mines", "records", "actions", "bytes/action", "time[ms]", "games/s");
+	for (const auto& level : levels)
+	{
+		std::vector<std::vector<uint8_t>> files;
+		size_t actions = 0;
+		size_t bytes = 0;
+		for (uint32_t i = 0; i < records; i++)
+		{
+			const auto record = CreateRecord(level.Size, level.Mines, i);
+			actions += record.GetActions().size();
+			files.emplace_back(record.Serialize());
+			bytes += files.back().size();
+		}
+		// 読み込みと再生を合わせて計測する
+		Game game(level.Size, level.Mines);
+		const auto time = MeasureMinimum(5,
+			[]() { return 0; },
+			[&](int)
+			{
+				for (const auto& file : files)
+					GameRecord::Deserialize(file).Replay(game);
+			});
+		std::printf("%-12s %6u %6u %10u %8u %10zu %12.2f %12.3f %12.0f\n", "replay", level.Size.Width, level.Size.Height, level.Mines, records, actions, static_cast<double>(bytes) / actions, ToMilliseconds(time), records / std::chrono::duration<double>(time).count());
+	}
+}
@@ -0,0 +1,172 @@
+﻿#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "Benchmark.h"
+#include "GameServer.h"
+#include "Instrumentation.h"
+#include "Random.h"
+
+namespace
+{
+	// 負荷をかけるクライアント側のセッション。要求は常に 1 つだけ送り、応答を受けてから次を送る
+	struct ClientSession
+	{
+		uint64_t Session;
+		uint32_t Step;
+		uint32_t Offset;
+		bool IsClosing;
+		std::chrono::steady_clock::time_point SentTime;
+	};
+
+	// 応答を処理するスレッドが競合しないよう、集計を分けて持つ
+	struct alignas(64) Shard
+	{
+		std::mutex Mutex;
+		LatencyHistogram Histogram;
+	};
+
+	class LoadGenerator
+	{
+	public:
+		LoadGenerator(const Size& size, uint32_t mines, uint32_t sessions, uint32_t threads) :
+			m_Size(size),
+			m_Mines(mines),
+			m_Clients(sessions),
+			m_Order(static_cast<size_t>(size.Width) * size.Height),
+			m_Active(sessions),
+			m_Deadline(),
+			m_Shards(new Shard[ShardCount]),
+			m_Server(threads, [this](std::string_view reply) { OnReply(reply); })
+		{
+			// すべてのセッションで同じ順にセルを開く（開き始める位置はセッションごとにずらす）
+			std::iota(m_Order.begin(), m_Order.end(), 0u);
+			Random random(1);
+			for (size_t i = m_Order.size() - 1; i > 0; i--)
+				std::swap(m_Order[i], m_Order[static_cast<size_t>(random.NextBelow(i + 1))]);
+		}
+
+		size_t GetThreadCount() const { return m_Server.GetThreadCount(); }
+		// duration が過ぎるまで要求を送り続け、すべての応答を受け取るまで待つ
+		LatencyHistogram Run(std::chrono::nanoseconds duration)
+		{
+			m_Deadline = std::chrono::steady_clock::now() + duration;
+			for (uint32_t i = 0; i < m_Clients.size(); i++)
+			{
+				m_Clients[i].Offset = i;
+				SendNew(i);
+			}
+			{
+				std::unique_lock lock(m_FinishedMutex);
+				m_Finished.wait(lock, [this]() { return m_Active.load() == 0; });
+			}
+			LatencyHistogram total;
+			for (size_t i = 0; i < ShardCount; i++)
+				total.Merge(m_Shards[i].Histogram);
+			return total;
+		}
+
+	private:
+		constexpr static size_t ShardCount = 64;
+
+		Size m_Size;
+		uint32_t m_Mines;
+		std::vector<ClientSession> m_Clients;
+		std::vector<uint32_t> m_Order;
+		std::atomic<uint32_t> m_Active;
+		std::chrono::steady_clock::time_point m_Deadline;
+		std::mutex m_FinishedMutex;
+		std::condition_variable m_Finished;
+		std::unique_ptr<Shard[]> m_Shards;
+		// 最後に破棄し、受け付けた要求をすべて処理させる
+		GameServer m_Server;
+
+		template <typename... TArgs> void Send(uint32_t client, const char* format, TArgs... args)
+		{
+			char buffer[96];
+			const auto length = std::snprintf(buffer, sizeof(buffer), format, client, args...);
+			m_Clients[client].SentTime = std::chrono::steady_clock::now();
+			m_Server.Submit(std::string_view(buffer, static_cast<size_t>(length)));
+		}
+		void SendNew(uint32_t client)
+		{
+			m_Clients[client].Step = 0;
+			m_Clients[client].IsClosing = false;
+			Send(client, "%u new %u %u %u %u", m_Size.Width, m_Size.Height, m_Mines, client);
+		}
+		void SendOpen(uint32_t client)
+		{
+			auto& state = m_Clients[client];
+			const auto index = m_Order[(state.Offset + state.Step++) % m_Order.size()];
+			Send(client, "%u open %llu %u %u", static_cast<unsigned long long>(state.Session), index % m_Size.Width, index / m_Size.Width);
+		}
+		void SendClose(uint32_t client)
+		{
+			m_Clients[client].IsClosing = true;
+			Send(client, "%u close %llu", static_cast<unsigned long long>(m_Clients[client].Session));
+		}
+
+		void OnReply(std::string_view reply)
+		{
+			const auto now = std::chrono::steady_clock::now();
+			uint32_t client = 0;
+			const auto end = reply.data() + reply.size();
+			const auto tag = std::from_chars(reply.data(), end, client);
+			auto& state = m_Clients[client];
+			{
+				auto& shard = m_Shards[client % ShardCount];
+				std::lock_guard lock(shard.Mutex);
+				shard.Histogram.Add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - state.SentTime).count()));
+			}
+			if (now >= m_Deadline)
+			{
+				if (m_Active.fetch_sub(1) == 1)
+				{
+					std::lock_guard lock(m_FinishedMutex);
+					m_Finished.notify_one();
+				}
+				return;
+			}
+			const std::string_view body(tag.ptr, static_cast<size_t>(end - tag.ptr));
+			if (state.IsClosing)
+				SendNew(client);
+			else if (state.Step == 0)
+			{
+				std::from_chars(body.data() + body.find_last_of(' ') + 1, end, state.Session);
+				SendOpen(client);
+			}
+			// 地雷を開くか、すべてのセルを試したらゲームを閉じて次を始める
+			else if (!body.ends_with("in_progress") || state.Step == m_Order.size())
+				SendClose(client);
+			else
+				SendOpen(client);
+		}
+	};
+}
+
+void RunServerBenchmark()
+{
+	constexpr Size size(16, 16);
+	constexpr uint32_t mines = 40;
+	constexpr auto duration = std::chrono::seconds(1);
+	const uint32_t sessionCounts[] = { 64, 4096 };
+	const uint32_t threadCounts[] = { 1, 0 };
+	std::printf("%-12s %8s %8s %10s %12s %10s %10s %10s %10s\n", "benchmark", "threads", "sessions", "requests", "requests/s", "p50[us]", "p95[us]", "p99[us]", "max[us]");
+	for (const auto threads : threadCounts)
+	{
+		for (const auto sessions : sessionCounts)
+		{
+			LoadGenerator generator(size, mines, sessions, threads);
+			const auto result = generator.Run(duration);
+			std::printf("%-12s %8zu %8u %10llu %12.0f %10.1f %10.1f %10.1f %10.1f\n", "server", generator.GetThreadCount(), sessions,
+				static_cast<unsigned long long>(result.GetCount()), static_cast<double>(result.GetCount()) / std::chrono::duration<double>(duration).count(),
+				result.GetPercentile(50) / 1e3, result.GetPercentile(95) / 1e3, result.GetPercentile(99) / 1e3, result.GetMaximum() / 1e3);
+		}
+	}
+}
@@ -0,0 +1,33 @@
+﻿#include <cstdio>
+#include <filesystem>
+#include "Benchmark.h"
+#include "Game.h"
+#include "GameSnapshot.h"
+
+void RunSnapshotBenchmark()
+{
+	constexpr Size sizes[] = { { 1000, 1000 }, { 10000, 10000 } };
+	const auto path = std::filesystem::temp_directory_path() / "MineSweeper.Benchmark.snapshot";
+	std::printf("%-12s %6s %6s %10s %12s %12s %12s %14s\n", "benchmark", "width", "height", "mines", "size[MiB]", "save[ms]", "load[ms]", "load+scan[ms]");
+	for (const auto& size : sizes)
+	{
+		const uint64_t cells = static_cast<uint64_t>(size.Width) * size.Height;
+		Game game(size, static_cast<uint32_t>(cells / 5), 1);
+		game.OpenCell(Point(size.Width / 2, size.Height / 2));
+		const auto save = MeasureMinimum(3, []() { return 0; }, [&](int) { GameSnapshot::Save(game, path); });
+		const auto load = MeasureMinimum(5, []() { return 0; }, [&](int) { GameSnapshot::Load(path); });
+		// 読み込んだ後にすべてのセルに触れ、ページフォールトを含めた時間を計測する
+		size_t mines = 0;
+		const auto scan = MeasureMinimum(3, []() { return 0; },
+			[&](int)
+			{
+				const auto loaded = GameSnapshot::Load(path);
+				mines = 0;
+				for (const auto& cell : loaded.GetCells())
+					mines += cell.HasMine;
+			});
+		const auto megabytes = static_cast<double>(std::filesystem::file_size(path)) / (1024 * 1024);
+		std::printf("%-12s %6u %6u %10zu %12.1f %12.3f %12.3f %14.3f\n", "snapshot", size.Width, size.Height, mines, megabytes, ToMilliseconds(save), ToMilliseconds(load), ToMilliseconds(scan));
+	}
+	std::filesystem::remove(path);
+}
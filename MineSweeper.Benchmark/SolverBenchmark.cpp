@@ -0,0 +1,39 @@
+﻿#include <chrono>
+#include <cstdio>
+#include "Benchmark.h"
+#include "Game.h"
+#include "Solver.h"
+
+void RunSolverBenchmark()
+{
+	struct Level
+	{
+		::Size Size;
+		uint32_t Mines;
+	};
+	constexpr Level levels[] = { { { 9, 9 }, 10 }, { { 16, 16 }, 40 }, { { 30, 16 }, 99 }, { { 1000, 1000 }, 150000 } };
+	std::printf("%-12s %6s %6s %10s %8s %8s %12s %12s\n", "benchmark", "width", "height", "mines", "games", "solved", "time[ms]", "solves/s");
+	for (const auto& level : levels)
+	{
+		const uint64_t cells = static_cast<uint64_t>(level.Size.Width) * level.Size.Height;
+		const uint32_t games = cells > 100000 ? 5 : 10000;
+		const Point first(level.Size.Width / 2, level.Size.Height / 2);
+		uint32_t solved = 0;
+		std::chrono::nanoseconds total(0);
+		for (uint32_t i = 0; i < games; i++)
+		{
+			// 地雷の配置は計測に含めない
+			Game game(level.Size, level.Mines);
+			game.PlaceMines(first);
+			Stopwatch stopwatch;
+			Solver solver(game);
+			solver.Open(first);
+			solver.Solve();
+			total += stopwatch.GetElapsed();
+			if (game.GetProgress() == GameProgress::Completed)
+				solved++;
+		}
+		const auto seconds = std::chrono::duration<double>(total).count();
+		std::printf("%-12s %6u %6u %10u %8u %7.1f%% %12.3f %12.0f\n", "solver", level.Size.Width, level.Size.Height, level.Mines, games, 100.0 * solved / games, ToMilliseconds(total), games / seconds);
+	}
+}
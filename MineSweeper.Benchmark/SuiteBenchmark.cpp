@@ -0,0 +1,256 @@
+﻿#include <atomic>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+#include "Benchmark.h"
+#include "Game.h"
+
+namespace
+{
+	// 描画結果を画面の代わりにメモリ上の文字の配列に書き込む
+	class MemoryRenderer : public GameRenderer
+	{
+	public:
+		explicit MemoryRenderer(const Size& size) : m_Width(size.Width), m_Characters(static_cast<size_t>(size.Width) * size.Height, ' '), m_UnflaggedMines(0) { }
+
+		void BeginFrame() override { }
+		void RenderCell(const Point& loc, const Cell& cell, bool opening) override
+		{
+			char character;
+			if (cell.State == CellState::Flagged)
+				character = 'F';
+			else if (cell.State != CellState::Open)
+				character = opening ? 'o' : '#';
+			else if (cell.HasMine)
+				character = '*';
+			else
+				character = static_cast<char>('0' + cell.AroundMines);
+			m_Characters[static_cast<size_t>(loc.Y) * m_Width + loc.X] = character;
+		}
+		void RenderMineCounter(int32_t unflaggedMines) override { m_UnflaggedMines = unflaggedMines; }
+		void EndFrame() override { }
+
+	private:
+		uint32_t m_Width;
+		std::vector<char> m_Characters;
+		int32_t m_UnflaggedMines;
+	};
+
+	struct Measurement
+	{
+		// 1 回の計測で操作を呼び出した回数と、その間に処理したセルなどの数
+		uint64_t Iterations;
+		uint64_t Items;
+		std::chrono::nanoseconds Time;
+	};
+
+	// 小さな盤面では 1 回の計測で複数の盤面を処理し、計測する時間を十分な長さにする
+	constexpr size_t TargetCells = size_t(1) << 20;
+	// 盤面の大きさに依らない操作を 1 回の計測で呼び出す回数
+	constexpr uint64_t QueryIterations = uint64_t(1) << 20;
+
+	size_t CountCells(const Size& size) { return static_cast<size_t>(size.Width) * size.Height; }
+	size_t CountGames(const Size& size) { return std::max<size_t>(1, TargetCells / CountCells(size)); }
+	uint32_t CountRepeats(const Size& size) { return CountCells(size) >= TargetCells ? 3 : 7; }
+	Point GetCenter(const Size& size) { return Point(size.Width / 2, size.Height / 2); }
+
+	std::vector<Game> CreateGames(const Size& size, uint32_t mines, bool placeMines)
+	{
+		std::vector<Game> games;
+		const auto count = CountGames(size);
+		games.reserve(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			games.emplace_back(size, mines, i);
+			if (placeMines)
+				games.back().PlaceMines(GetCenter(size));
+		}
+		return games;
+	}
+	void FlagAllMines(Game& game)
+	{
+		for (const auto& loc : AllPointView(game.GetSize()))
+		{
+			if (game.GetCell(loc).HasMine)
+				game.SwitchFlaggedState(loc);
+		}
+	}
+
+	Measurement MeasurePlaceMines(const Size& size, uint32_t mines)
+	{
+		const auto time = MeasureMinimum(CountRepeats(size),
+			[&]() { return CreateGames(size, mines, false); },
+			[&](std::vector<Game>& games)
+			{
+				for (auto& game : games)
+					game.PlaceMines(GetCenter(size));
+			});
+		return { CountGames(size), CountGames(size) * CountCells(size), time };
+	}
+	Measurement MeasureOpenCell(const Size& size, uint32_t mines)
+	{
+		uint64_t opened = 0;
+		const auto time = MeasureMinimum(CountRepeats(size),
+			[&]() { return CreateGames(size, mines, true); },
+			[&](std::vector<Game>& games)
+			{
+				opened = 0;
+				for (auto& game : games)
+					opened += game.OpenCell(GetCenter(size));
+			});
+		return { CountGames(size), opened, time };
+	}
+	// すべての地雷に旗を立てて中央を開いた盤面で、行優先の順にすべてのセルを両ボタンで開く
+	Measurement MeasureOpenCellsWithMineIndicator(const Size& size, uint32_t mines)
+	{
+		uint64_t opened = 0;
+		const auto time = MeasureMinimum(CountRepeats(size),
+			[&]()
+			{
+				auto games = CreateGames(size, mines, true);
+				for (auto& game : games)
+				{
+					FlagAllMines(game);
+					game.OpenCell(GetCenter(size));
+				}
+				return games;
+			},
+			[&](std::vector<Game>& games)
+			{
+				opened = 0;
+				for (auto& game : games)
+				{
+					for (const auto& loc : AllPointView(size))
+						opened += game.OpenCellsWithMineIndicator(loc);
+				}
+			});
+		return { CountGames(size) * CountCells(size), opened, time };
+	}
+	// 値を使わない呼び出しが取り除かれたり、ループの外に出されたりしないようにする
+	template <typename TQuery> Measurement MeasureQuery(const Size& size, uint32_t mines, TQuery query)
+	{
+		volatile int64_t sink = 0;
+		const auto time = MeasureMinimum(CountRepeats(size),
+			[&]()
+			{
+				Game game(size, mines, 0);
+				game.OpenCell(GetCenter(size));
+				FlagAllMines(game);
+				return game;
+			},
+			[&](Game& game)
+			{
+				for (uint64_t i = 0; i < QueryIterations; i++)
+				{
+					sink = query(game);
+					std::atomic_signal_fence(std::memory_order_seq_cst);
+				}
+			});
+		return { QueryIterations, QueryIterations, time };
+	}
+	Measurement MeasureGetProgress(const Size& size, uint32_t mines) { return MeasureQuery(size, mines, [](const Game& game) { return static_cast<int64_t>(game.GetProgress()); }); }
+	Measurement MeasureCountUnflaggedMines(const Size& size, uint32_t mines) { return MeasureQuery(size, mines, [](const Game& game) { return static_cast<int64_t>(game.CountUnflaggedMines()); }); }
+	// すべてのセルの周囲を AroundPointView でたどり、地雷の数を数える
+	Measurement MeasureAroundPointView(const Size& size, uint32_t mines)
+	{
+		uint64_t found = 0;
+		const auto time = MeasureMinimum(CountRepeats(size),
+			[&]() { return CreateGames(size, mines, true); },
+			[&](std::vector<Game>& games)
+			{
+				found = 0;
+				for (const auto& game : games)
+				{
+					for (const auto& loc : AllPointView(size))
+					{
+						for (const auto& pos : AroundPointView(loc, size))
+							found += game.GetCell(pos).HasMine;
+					}
+				}
+			});
+		return { CountGames(size) * CountCells(size), found, time };
+	}
+	// 盤面全体を表示範囲とし、すべてのセルを描画する
+	Measurement MeasureRender(const Size& size, uint32_t mines)
+	{
+		MemoryRenderer renderer(size);
+		const auto time = MeasureMinimum(CountRepeats(size),
+			[&]()
+			{
+				auto games = CreateGames(size, mines, true);
+				for (auto& game : games)
+				{
+					game.OpenCell(GetCenter(size));
+					game.Render(renderer);
+					game.InvalidateAll();
+				}
+				return games;
+			},
+			[&](std::vector<Game>& games)
+			{
+				for (auto& game : games)
+					game.Render(renderer);
+			});
+		return { CountGames(size), CountGames(size) * CountCells(size), time };
+	}
+
+	struct Operation
+	{
+		const char* Name;
+		Measurement(*Measure)(const Size&, uint32_t);
+	};
+
+	constexpr Operation operations[] =
+	{
+		{ "place_mines", MeasurePlaceMines },
+		{ "open_cell", MeasureOpenCell },
+		{ "open_cells_with_mine_indicator", MeasureOpenCellsWithMineIndicator },
+		{ "get_progress", MeasureGetProgress },
+		{ "count_unflagged_mines", MeasureCountUnflaggedMines },
+		{ "around_point_view", MeasureAroundPointView },
+		{ "render", MeasureRender },
+	};
+}
+
+bool RunSuiteBenchmark(std::string_view format)
+{
+	const bool json = format == "json";
+	if (!json && format != "csv")
+		return false;
+	constexpr Size sizes[] = { { 9, 9 }, { 16, 16 }, { 30, 16 }, { 64, 64 }, { 256, 256 }, { 1024, 1024 }, { 4096, 4096 } };
+	constexpr double densities[] = { 1.0, 12.0, 20.0 };
+	if (json)
+		std::printf("{\n  \"benchmark\": \"suite\",\n  \"results\": [");
+	else
+		std::printf("operation,width,height,density,mines,iterations,items,total_ns,ns_per_iteration\n");
+	bool first = true;
+	for (const auto& size : sizes)
+	{
+		for (const auto density : densities)
+		{
+			const auto mines = static_cast<uint32_t>(static_cast<double>(CountCells(size)) * density / 100);
+			for (const auto& operation : operations)
+			{
+				const auto result = operation.Measure(size, mines);
+				const auto perIteration = static_cast<double>(result.Time.count()) / static_cast<double>(result.Iterations);
+				if (json)
+				{
+					std::printf("%s\n    { \"operation\": \"%s\", \"width\": %u, \"height\": %u, \"density\": %.1f, \"mines\": %u, \"iterations\": %llu, \"items\": %llu, \"total_ns\": %lld, \"ns_per_iteration\": %.3f }",
+						first ? "" : ",", operation.Name, size.Width, size.Height, density, mines,
+						static_cast<unsigned long long>(result.Iterations), static_cast<unsigned long long>(result.Items), static_cast<long long>(result.Time.count()), perIteration);
+				}
+				else
+				{
+					std::printf("%s,%u,%u,%.1f,%u,%llu,%llu,%lld,%.3f\n",
+						operation.Name, size.Width, size.Height, density, mines,
+						static_cast<unsigned long long>(result.Iterations), static_cast<unsigned long long>(result.Items), static_cast<long long>(result.Time.count()), perIteration);
+				}
+				std::fflush(stdout);
+				first = false;
+			}
+		}
+	}
+	if (json)
+		std::printf("\n  ]\n}\n");
+	return true;
+}
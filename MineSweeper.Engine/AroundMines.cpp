@@ -0,0 +1,82 @@
+﻿#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "AroundMines.h"
+
+void CountAroundMinesByScatter(std::span<Cell> cells, const Size& size, std::span<const size_t> mineIndices)
+{
+	const size_t width = size.Width;
+	for (auto index : mineIndices)
+	{
+		const size_t x = index % width;
+		const size_t y = index / width;
+		const size_t left = x > 0 ? x - 1 : x;
+		const size_t right = x + 1 < width ? x + 1 : x;
+		const size_t top = y > 0 ? y - 1 : y;
+		const size_t bottom = y + 1 < size.Height ? y + 1 : y;
+		for (size_t j = top; j <= bottom; j++)
+		{
+			for (size_t i = left; i <= right; i++)
+				cells[j * width + i].AroundMines++;
+		}
+		// 地雷自身には加算しない
+		cells[index].AroundMines--;
+	}
+}
+
+namespace
+{
+	// mines は両端に番兵の 0 を持つ幅 + 2 の配列
+	void LoadMineRow(std::span<const Cell> row, std::span<uint8_t> mines)
+	{
+		for (size_t x = 0; x < row.size(); x++)
+			mines[x + 1] = row[x].HasMine;
+	}
+	void SumHorizontally(std::span<const uint8_t> mines, std::span<uint8_t> sums)
+	{
+		const uint8_t* source = mines.data();
+		uint8_t* destination = sums.data();
+		for (size_t x = 0, width = sums.size(); x < width; x++)
+			destination[x] = static_cast<uint8_t>(source[x] + source[x + 1] + source[x + 2]);
+	}
+}
+
+void CountAroundMinesByRowSum(std::span<Cell> cells, const Size& size)
+{
+	std::vector<uint8_t> buffer;
+	CountAroundMinesByRowSum(cells, size, buffer);
+}
+
+void CountAroundMinesByRowSum(std::span<Cell> cells, const Size& size, std::vector<uint8_t>& buffer)
+{
+	const size_t width = size.Width;
+	// 2 行分の地雷の有無と 4 行分の和を 1 つの領域から切り出す
+	buffer.assign((width + 2) * 2 + width * 4, 0);
+	const std::span<uint8_t> whole(buffer);
+	auto currentMines = whole.subspan(0, width + 2);
+	auto belowMines = whole.subspan(width + 2, width + 2);
+	auto aboveSums = whole.subspan((width + 2) * 2, width);
+	auto currentSums = whole.subspan((width + 2) * 2 + width, width);
+	auto belowSums = whole.subspan((width + 2) * 2 + width * 2, width);
+	const auto counts = whole.subspan((width + 2) * 2 + width * 3, width);
+	LoadMineRow(cells.subspan(0, width), currentMines);
+	SumHorizontally(currentMines, currentSums);
+	for (size_t y = 0; y < size.Height; y++)
+	{
+		if (y + 1 < size.Height)
+		{
+			LoadMineRow(cells.subspan((y + 1) * width, width), belowMines);
+			SumHorizontally(belowMines, belowSums);
+		}
+		else
+			std::ranges::fill(belowSums, 0);
+		for (size_t x = 0; x < width; x++)
+			counts[x] = static_cast<uint8_t>(aboveSums[x] + currentSums[x] + belowSums[x] - currentMines[x + 1]);
+		auto row = cells.subspan(y * width, width);
+		for (size_t x = 0; x < width; x++)
+			row[x].AroundMines = counts[x];
+		std::swap(aboveSums, currentSums);
+		std::swap(currentSums, belowSums);
+		std::swap(currentMines, belowMines);
+	}
+}
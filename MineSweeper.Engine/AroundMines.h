@@ -0,0 +1,15 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Game.h"
+
+// 地雷の周囲 8 セルに 1 ずつ加算して周囲の地雷数を求める（地雷の少ない盤面向け、計算量は地雷数に比例）
+// cells の AroundMines はすべて 0 であること
+void CountAroundMinesByScatter(std::span<Cell> cells, const Size& size, std::span<const size_t> mineIndices);
+// 行ごとに横 3 セルの和を求め、上下 3 行分を足し合わせて周囲の地雷数を求める（地雷の多い盤面向け、計算量はセル数に比例）
+void CountAroundMinesByRowSum(std::span<Cell> cells, const Size& size);
+// 作業用の領域に buffer を使う（容量が足りていれば確保し直さない）
+void CountAroundMinesByRowSum(std::span<Cell> cells, const Size& size, std::vector<uint8_t>& buffer);
@@ -0,0 +1,120 @@
+﻿#include <bit>
+#include "BitBoard.h"
+
+BitBoard::BitBoard(const Size& size) :
+	m_Size(size),
+	m_WordsPerRow((static_cast<size_t>(size.Width) + 63) / 64),
+	m_Mines(m_WordsPerRow * size.Height),
+	m_Open(m_WordsPerRow * size.Height),
+	m_Flagged(m_WordsPerRow * size.Height) { }
+
+BitBoard::BitBoard(const Size& size, std::span<const Cell> cells) : BitBoard(size)
+{
+	for (const auto& loc : AllPointView(size))
+	{
+		const auto& cell = cells[static_cast<size_t>(loc.Y) * size.Width + loc.X];
+		SetMine(loc, cell.HasMine);
+		SetOpen(loc, cell.State == CellState::Open);
+		SetFlagged(loc, cell.State == CellState::Flagged);
+	}
+}
+
+size_t BitBoard::CountMines() const
+{
+	size_t count = 0;
+	for (auto word : m_Mines)
+		count += std::popcount(word);
+	return count;
+}
+
+size_t BitBoard::CountFlags() const
+{
+	size_t count = 0;
+	for (auto word : m_Flagged)
+		count += std::popcount(word);
+	return count;
+}
+
+size_t BitBoard::CountOpenedSafeCells() const
+{
+	size_t count = 0;
+	for (size_t i = 0; i < m_Open.size(); i++)
+		count += std::popcount(m_Open[i] & ~m_Mines[i]);
+	return count;
+}
+
+bool BitBoard::HasOpenedMine() const
+{
+	uint64_t any = 0;
+	for (size_t i = 0; i < m_Open.size(); i++)
+		any |= m_Open[i] & m_Mines[i];
+	return any != 0;
+}
+
+GameProgress BitBoard::GetProgress() const
+{
+	if (HasOpenedMine())
+		return GameProgress::Failed;
+	if (CountOpenedSafeCells() == static_cast<size_t>(m_Size.Width) * m_Size.Height - CountMines())
+		return GameProgress::Completed;
+	return GameProgress::InProgress;
+}
+
+void BitBoard::OpenAllMines()
+{
+	// Cell と同様に、開いた地雷からは旗を取り除く
+	for (size_t i = 0; i < m_Open.size(); i++)
+	{
+		m_Open[i] |= m_Mines[i];
+		m_Flagged[i] &= ~m_Mines[i];
+	}
+}
+
+namespace
+{
+	// 4 ビットの計数器 (sum[0] が最下位) の各ビット位置に input を 1 ずつ加える
+	inline void Accumulate(std::array<uint64_t, 4>& sum, uint64_t input)
+	{
+		uint64_t carry = input;
+		for (auto& bit : sum)
+		{
+			const uint64_t next = bit & carry;
+			bit ^= carry;
+			carry = next;
+		}
+	}
+}
+
+void BitBoard::UpdateAroundMines()
+{
+	for (auto& plane : m_AroundMines)
+		plane.assign(m_Mines.size(), 0);
+	const size_t height = m_Size.Height;
+	for (size_t y = 0; y < height; y++)
+	{
+		const uint64_t* rows[3] = {
+			y > 0 ? &m_Mines[(y - 1) * m_WordsPerRow] : nullptr,
+			&m_Mines[y * m_WordsPerRow],
+			y + 1 < height ? &m_Mines[(y + 1) * m_WordsPerRow] : nullptr,
+		};
+		for (size_t w = 0; w < m_WordsPerRow; w++)
+		{
+			std::array<uint64_t, 4> sum{};
+			for (size_t r = 0; r < 3; r++)
+			{
+				if (!rows[r])
+					continue;
+				const uint64_t center = rows[r][w];
+				const uint64_t previous = w > 0 ? rows[r][w - 1] : 0;
+				const uint64_t next = w + 1 < m_WordsPerRow ? rows[r][w + 1] : 0;
+				// 左隣のセルの値をビット x に、右隣のセルの値をビット x に揃える
+				Accumulate(sum, center << 1 | previous >> 63);
+				Accumulate(sum, center >> 1 | next << 63);
+				if (r != 1)
+					Accumulate(sum, center);
+			}
+			for (size_t i = 0; i < sum.size(); i++)
+				m_AroundMines[i][y * m_WordsPerRow + w] = sum[i];
+		}
+	}
+}
@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Game.h"
+
+// 地雷・開いている・旗の状態をそれぞれ 1 セル 1 ビットの面に分けて保持する盤面
+// 各行は 64 ビット単位に切り上げて格納し、行の末尾の余りのビットは常に 0 にしておく
+class BitBoard
+{
+public:
+	explicit BitBoard(const Size& size);
+	BitBoard(const Size& size, std::span<const Cell> cells);
+
+	constexpr const Size& GetSize() const { return m_Size; }
+	bool HasMine(const Point& loc) const { return GetBit(m_Mines, loc); }
+	bool IsOpen(const Point& loc) const { return GetBit(m_Open, loc); }
+	bool IsFlagged(const Point& loc) const { return GetBit(m_Flagged, loc); }
+	void SetMine(const Point& loc, bool value) { SetBit(m_Mines, loc, value); }
+	void SetOpen(const Point& loc, bool value) { SetBit(m_Open, loc, value); }
+	void SetFlagged(const Point& loc, bool value) { SetBit(m_Flagged, loc, value); }
+	// UpdateAroundMines で求めた周囲の地雷数を返す
+	uint8_t GetAroundMines(const Point& loc) const
+	{
+		uint8_t value = 0;
+		for (size_t i = 0; i < m_AroundMines.size(); i++)
+			value |= static_cast<uint8_t>(GetBit(m_AroundMines[i], loc) << i);
+		return value;
+	}
+
+	size_t CountMines() const;
+	size_t CountFlags() const;
+	size_t CountOpenedSafeCells() const;
+	bool HasOpenedMine() const;
+	GameProgress GetProgress() const;
+	int32_t CountUnflaggedMines() const { return static_cast<int32_t>(static_cast<int64_t>(CountMines()) - static_cast<int64_t>(CountFlags())); }
+
+	void OpenAllMines();
+	// 全セルの周囲の地雷数を 64 セルずつビット並列の加算器で求め、4 枚のビット面に格納する
+	void UpdateAroundMines();
+
+private:
+	Size m_Size;
+	size_t m_WordsPerRow;
+	std::vector<uint64_t> m_Mines;
+	std::vector<uint64_t> m_Open;
+	std::vector<uint64_t> m_Flagged;
+	std::array<std::vector<uint64_t>, 4> m_AroundMines;
+
+	size_t WordIndexOf(const Point& loc) const { return loc.Y * m_WordsPerRow + loc.X / 64; }
+	bool GetBit(const std::vector<uint64_t>& plane, const Point& loc) const { return (plane[WordIndexOf(loc)] >> (loc.X % 64)) & 1u; }
+	void SetBit(std::vector<uint64_t>& plane, const Point& loc, bool value)
+	{
+		const auto mask = uint64_t(1) << (loc.X % 64);
+		if (value)
+			plane[WordIndexOf(loc)] |= mask;
+		else
+			plane[WordIndexOf(loc)] &= ~mask;
+	}
+};
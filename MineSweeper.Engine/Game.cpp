@@ -0,0 +1,408 @@
+﻿#include <algorithm>
+#include <array>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+#include "AroundMines.h"
+#include "Game.h"
+
+namespace
+{
+	// 同じセル数について保持する領域の数の上限
+	constexpr size_t MaximumPooledBuffersPerSize = 4;
+	// すべてのスレッドが保持するセルの合計の上限（これを超える分は再利用せずに解放する）
+	constexpr size_t MaximumPooledCells = size_t(1) << 28;
+	// すべてのスレッドが保持しているセルの合計（ロックを取らずに上限と比べる）
+	std::atomic<size_t> PooledCells = 0;
+
+	// スレッドの終了時に領域の保持を終えた後で Game が破棄されても、破棄済みの保持先に触れないようにする
+	thread_local bool IsBufferPoolDestroyed = false;
+}
+
+// 破棄された Game の領域をセル数ごとに保持する
+// スレッドごとに持つので、多数のスレッドが Game を作成・破棄してもロックを取らない
+struct Game::BufferPool
+{
+	std::unordered_map<size_t, std::vector<Buffers>> Entries;
+	size_t Cells = 0;
+
+	~BufferPool()
+	{
+		PooledCells.fetch_sub(Cells, std::memory_order_relaxed);
+		IsBufferPoolDestroyed = true;
+	}
+};
+
+Game::Game(const Size& size, uint32_t mines, uint64_t seed) : Game(size, mines, seed, AcquireBuffers(size)) { }
+
+Game::Game(const Size& size, uint32_t mines, uint64_t seed, Buffers&& buffers) : Game(size, mines, seed, CellArray(buffers.Cells.release()))
+{
+	m_History = std::move(buffers.History);
+	m_SearchLocations = std::move(buffers.SearchLocations);
+	m_DirtyLocations = std::move(buffers.DirtyLocations);
+	m_DirtyFlags = std::move(buffers.DirtyFlags);
+	m_MineIndices = std::move(buffers.MineIndices);
+	m_RowSums = std::move(buffers.RowSums);
+}
+
+Game::~Game()
+{
+	// 写像したファイルのセルなど、Game が確保したのではない領域は再利用しない
+	if (m_Cells && !m_Cells.get_deleter().Owner)
+		ReleaseBuffers();
+}
+
+Game::BufferPool* Game::GetBufferPool()
+{
+	if (IsBufferPoolDestroyed)
+		return nullptr;
+	thread_local BufferPool pool;
+	return &pool;
+}
+
+Game::Buffers Game::AcquireBuffers(const Size& size)
+{
+	const auto cells = static_cast<size_t>(size.Width) * size.Height;
+	Buffers buffers;
+	if (const auto pool = GetBufferPool())
+	{
+		const auto it = pool->Entries.find(cells);
+		if (it != pool->Entries.end() && !it->second.empty())
+		{
+			buffers = std::move(it->second.back());
+			it->second.pop_back();
+			pool->Cells -= cells;
+			PooledCells.fetch_sub(cells, std::memory_order_relaxed);
+			std::fill_n(buffers.Cells.get(), cells, Cell());
+		}
+	}
+	if (!buffers.Cells)
+		buffers.Cells.reset(new Cell[cells]());
+	if (cells <= MaximumPreallocatedCells)
+	{
+		// 探索候補は同じセルを 2 回積まないので、多くてもセル数
+		buffers.SearchLocations.reserve(cells);
+		// 変化したセルは表示範囲の 4 分の 1 を超えると個別に記録しない（表示範囲は盤面の内側）
+		buffers.DirtyLocations.reserve(cells / 4 + 1);
+		buffers.DirtyFlags.reserve(cells);
+		// 地雷の位置を記録するのは、地雷がセル数の ScatterDensityDivisor 分の 1 未満のときだけ
+		buffers.MineIndices.reserve(cells / ScatterDensityDivisor);
+		// 行単位の和に使う 2 行分の地雷の有無と 4 行分の和
+		buffers.RowSums.reserve((static_cast<size_t>(size.Width) + 2) * 2 + static_cast<size_t>(size.Width) * 4);
+	}
+	return buffers;
+}
+
+void Game::ReleaseBuffers()
+{
+	const auto cells = Cells().size();
+	m_History.SetEnabled(false);
+	m_SearchLocations.clear();
+	m_DirtyLocations.clear();
+	m_DirtyFlags.clear();
+	Buffers buffers { std::unique_ptr<Cell[]>(m_Cells.release()), std::move(m_History), std::move(m_SearchLocations), std::move(m_DirtyLocations), std::move(m_DirtyFlags), std::move(m_MineIndices), std::move(m_RowSums) };
+	const auto pool = GetBufferPool();
+	if (!pool)
+		return;
+	// 先に全体の上限から取り分を確保し、保持しなかった場合は戻す
+	if (PooledCells.fetch_add(cells, std::memory_order_relaxed) + cells > MaximumPooledCells)
+	{
+		PooledCells.fetch_sub(cells, std::memory_order_relaxed);
+		return;
+	}
+	try
+	{
+		auto& entries = pool->Entries[cells];
+		if (entries.size() < MaximumPooledBuffersPerSize)
+		{
+			entries.reserve(MaximumPooledBuffersPerSize);
+			entries.push_back(std::move(buffers));
+			pool->Cells += cells;
+			return;
+		}
+	}
+	catch (...)
+	{
+		// 保持できなければそのまま解放する
+	}
+	PooledCells.fetch_sub(cells, std::memory_order_relaxed);
+}
+
+void Game::ClearBufferPool()
+{
+	if (const auto pool = GetBufferPool())
+	{
+		pool->Entries.clear();
+		PooledCells.fetch_sub(pool->Cells, std::memory_order_relaxed);
+		pool->Cells = 0;
+	}
+}
+
+void Game::Render(GameRenderer& renderer)
+{
+	renderer.BeginFrame();
+	if (m_ShouldRenderAll)
+	{
+		for (const auto& offset : AllPointView(m_Viewport.GetSize()))
+		{
+			const Point loc(m_Viewport.X + offset.X, m_Viewport.Y + offset.Y);
+			renderer.RenderCell(loc, CellAt(loc), m_OpeningPosition && IsAround(loc, *m_OpeningPosition));
+		}
+		// 変化したセルの記録は全体を描画した後にしか行われないので、記録用のフラグはここで初めて用意する
+		m_DirtyFlags.assign(static_cast<size_t>(m_Viewport.Width) * m_Viewport.Height, false);
+		m_DirtyLocations.clear();
+	}
+	else
+	{
+		// 描画先でのカーソル移動が少なくなるよう行優先の順序で描画する
+		std::ranges::sort(m_DirtyLocations, [](const Point& left, const Point& right) { return left.Y != right.Y ? left.Y < right.Y : left.X < right.X; });
+		for (const auto& loc : m_DirtyLocations)
+			renderer.RenderCell(loc, CellAt(loc), m_OpeningPosition && IsAround(loc, *m_OpeningPosition));
+	}
+	for (const auto& loc : m_DirtyLocations)
+		m_DirtyFlags[static_cast<size_t>(loc.Y - m_Viewport.Y) * m_Viewport.Width + (loc.X - m_Viewport.X)] = false;
+	m_DirtyLocations.clear();
+	renderer.RenderMineCounter(CountUnflaggedMines());
+	renderer.EndFrame();
+	m_ShouldRenderAll = false;
+	m_ShouldRender = false;
+}
+
+void Game::SetViewport(const Rect& viewport)
+{
+	if (!viewport.IsContainedIn(m_Size))
+		throw std::out_of_range("The viewport must be contained in the board.");
+	if (viewport == m_Viewport)
+		return;
+	m_Viewport = viewport;
+	m_DirtyFlags.clear();
+	m_DirtyLocations.clear();
+	InvalidateAll();
+}
+
+size_t Game::OpenCell(const Point& loc)
+{
+	const bool hasMineExploded = m_HasMineExploded;
+	const auto opened = Open(loc);
+	m_History.Commit(hasMineExploded, m_HasMineExploded);
+	return opened;
+}
+
+size_t Game::Open(const Point& loc)
+{
+	if (CellAt(loc).State != CellState::Closed)
+		return 0;
+	if (m_MinesToBePlaced > 0)
+		PlaceMines(loc);
+	if (CellAt(loc).HasMine)
+	{
+		m_HasMineExploded = true;
+		OpenAllMines();
+		return 1;
+	}
+
+	// セルは探索候補に積む時点で開くので、同じセルが 2 回以上積まれることはない
+	// 周囲に地雷のないセルだけを積み、そこから周囲の閉じたセルを開いていく
+	size_t opened = 0;
+	const auto open = [this, &opened](uint32_t x, uint32_t y)
+	{
+		auto& cell = CellAt(x, y);
+		m_History.Record(static_cast<size_t>(y) * m_Size.Width + x, CellState::Closed, CellState::Open);
+		cell.State = CellState::Open;
+		Invalidate(Point(x, y));
+		opened++;
+		if (cell.AroundMines == 0)
+			m_SearchLocations.emplace_back(x, y);
+	};
+	m_SearchLocations.clear();
+	open(loc.X, loc.Y);
+	while (!m_SearchLocations.empty())
+	{
+		const auto center = m_SearchLocations.back();
+		m_SearchLocations.pop_back();
+		const uint32_t left = center.X > 0 ? center.X - 1 : center.X;
+		const uint32_t right = center.X + 1 < m_Size.Width ? center.X + 1 : center.X;
+		const uint32_t top = center.Y > 0 ? center.Y - 1 : center.Y;
+		const uint32_t bottom = center.Y + 1 < m_Size.Height ? center.Y + 1 : center.Y;
+		for (uint32_t y = top; y <= bottom; y++)
+		{
+			for (uint32_t x = left; x <= right; x++)
+			{
+				if (CellAt(x, y).State == CellState::Closed)
+					open(x, y);
+			}
+		}
+	}
+	m_OpenedSafeCells += opened;
+	return opened;
+}
+
+size_t Game::OpenCellsWithMineIndicator(const Point& loc)
+{
+	if (CellAt(loc).State != CellState::Open)
+		return 0;
+	size_t allArounds = 0;
+	std::array<Point, 8> locs;
+	size_t count = 0;
+	for (auto pos : AroundPointView(loc, m_Size))
+	{
+		if (CellAt(pos).State != CellState::Flagged)
+			locs[count++] = pos;
+		allArounds++;
+	}
+	if (count != allArounds - CellAt(loc).AroundMines)
+		return 0;
+	const bool hasMineExploded = m_HasMineExploded;
+	size_t opened = 0;
+	for (size_t i = 0; i < count; i++)
+		opened += Open(locs[i]);
+	m_History.Commit(hasMineExploded, m_HasMineExploded);
+	return opened;
+}
+
+void Game::SwitchFlaggedState(const Point& loc)
+{
+	auto& cell = CellAt(loc);
+	const auto before = cell.State;
+	if (!cell.SwitchFlaggedState())
+		return;
+	if (cell.State == CellState::Flagged)
+		m_FlaggedCells++;
+	else
+		m_FlaggedCells--;
+	Invalidate(loc);
+	m_History.Record(IndexOf(loc), before, cell.State);
+	m_History.Commit(m_HasMineExploded, m_HasMineExploded);
+}
+
+void Game::SetIsHistoryEnabled(bool value)
+{
+	m_History.SetEnabled(value);
+	if (value && Cells().size() <= MaximumPreallocatedCells)
+		m_History.Reserve(Cells().size());
+}
+
+bool Game::Undo()
+{
+	if (!CanUndo())
+		return false;
+	const auto index = m_History.GetPosition() - 1;
+	ApplyHistory(index, true);
+	m_History.SetPosition(index);
+	return true;
+}
+
+bool Game::Redo()
+{
+	if (!CanRedo())
+		return false;
+	const auto index = m_History.GetPosition();
+	ApplyHistory(index, false);
+	m_History.SetPosition(index + 1);
+	return true;
+}
+
+void Game::RewindHistory(size_t position)
+{
+	while (m_History.GetPosition() > position)
+		Undo();
+}
+
+void Game::ApplyHistory(size_t index, bool undo)
+{
+	for (const auto& run : m_History.GetRuns(index))
+	{
+		const auto state = undo ? run.Before : run.After;
+		for (auto cellIndex = run.Start; cellIndex < run.Start + run.Length; cellIndex++)
+		{
+			auto& cell = Cells()[cellIndex];
+			if (cell.State == CellState::Flagged)
+				m_FlaggedCells--;
+			else if (cell.State == CellState::Open && !cell.HasMine)
+				m_OpenedSafeCells--;
+			cell.State = state;
+			if (state == CellState::Flagged)
+				m_FlaggedCells++;
+			else if (state == CellState::Open && !cell.HasMine)
+				m_OpenedSafeCells++;
+			Invalidate(Point(static_cast<uint32_t>(cellIndex % m_Size.Width), static_cast<uint32_t>(cellIndex / m_Size.Width)));
+		}
+	}
+	m_HasMineExploded = undo ? m_History.HasMineExplodedBefore(index) : m_History.HasMineExplodedAfter(index);
+}
+
+void Game::PlaceMines(const Point& without)
+{
+	// 最初に開くセルとその周囲には地雷を置かない（周囲を除くと置ききれない場合は最初に開くセルのみを除外する）
+	std::array<size_t, 9> excluded{};
+	size_t excludedCount = 0;
+	excluded[excludedCount++] = IndexOf(without);
+	for (auto pos : AroundPointView(without, m_Size))
+		excluded[excludedCount++] = IndexOf(pos);
+	const size_t cells = Cells().size();
+	if (m_MinesToBePlaced > cells - excludedCount)
+		excludedCount = 1;
+	std::sort(excluded.begin(), excluded.begin() + excludedCount);
+	// 除外セルを飛ばして数えた候補番号をセル番号に変換する
+	const auto toCellIndex = [&excluded, excludedCount](size_t candidate)
+	{
+		for (size_t i = 0; i < excludedCount && excluded[i] <= candidate; i++)
+			candidate++;
+		return candidate;
+	};
+
+	// 地雷が疎な盤面では置いた地雷の周囲にだけ加算し、密な盤面では行単位の和で全セルを数える
+	const bool scatter = m_MinesToBePlaced < cells / ScatterDensityDivisor;
+	// 地雷の位置の記録には前回までに確保した領域を使う
+	m_MineIndices.clear();
+	if (scatter)
+		m_MineIndices.reserve(m_MinesToBePlaced);
+
+	// Floyd の標本抽出法で候補の中からちょうど m_MinesToBePlaced 個を重複なく選ぶ（乱数は地雷数と同じ回数しか引かない）
+	const size_t candidates = cells - excludedCount;
+	for (size_t j = candidates - m_MinesToBePlaced; j < candidates; j++)
+	{
+		auto index = toCellIndex(static_cast<size_t>(m_Random.NextBelow(j + 1)));
+		if (Cells()[index].HasMine)
+			index = toCellIndex(j);
+		Cells()[index].HasMine = true;
+		if (scatter)
+			m_MineIndices.emplace_back(index);
+	}
+	m_MinesToBePlaced = 0;
+	CountAroundMines(m_MineIndices);
+}
+
+void Game::PlaceMines(std::span<const size_t> mineIndices)
+{
+	if (mineIndices.size() != m_MinesToBePlaced)
+		throw std::invalid_argument("The number of mine indices must match the number of mines to be placed.");
+	for (auto index : mineIndices)
+		Cells()[index].HasMine = true;
+	m_MinesToBePlaced = 0;
+	CountAroundMines(mineIndices.size() < Cells().size() / ScatterDensityDivisor ? mineIndices : std::span<const size_t>());
+}
+
+// mineIndices が空でなければ地雷の周囲にだけ加算し、空であれば行単位の和で全セルを数える
+void Game::CountAroundMines(std::span<const size_t> mineIndices)
+{
+	if (!mineIndices.empty())
+		CountAroundMinesByScatter(Cells(), m_Size, mineIndices);
+	else
+		CountAroundMinesByRowSum(Cells(), m_Size, m_RowSums);
+}
+
+void Game::Reset(uint64_t seed)
+{
+	m_Seed = seed;
+	m_Random = Random(seed);
+	std::fill_n(m_Cells.get(), Cells().size(), Cell());
+	m_MinesToBePlaced = m_Mines;
+	m_OpenedSafeCells = 0;
+	m_FlaggedCells = 0;
+	m_HasMineExploded = false;
+	m_History.Clear();
+	m_OpeningPosition = std::nullopt;
+	m_DirtyLocations.clear();
+	InvalidateAll();
+}
@@ -0,0 +1,273 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Geometry.h"
+#include "GameHistory.h"
+#include "GameRenderer.h"
+#include "Random.h"
+
+enum class GameProgress
+{
+	InProgress = 0,
+	Completed = 1,
+	Failed = 2,
+};
+
+enum class CellState : uint8_t
+{
+	Closed = 0,
+	Flagged = 1,
+	Open = 2,
+};
+
+class Cell
+{
+public:
+	constexpr Cell() : AroundMines(0), HasMine(false), State(CellState::Closed) { }
+	uint8_t AroundMines : 5;
+	uint8_t HasMine : 1;
+	CellState State : 2;
+
+	constexpr bool SwitchFlaggedState()
+	{
+		if (State == CellState::Closed)
+		{
+			State = CellState::Flagged;
+			return true;
+		}
+		else if (State == CellState::Flagged)
+		{
+			State = CellState::Closed;
+			return true;
+		}
+		return false;
+	}
+};
+
+class Game
+{
+public:
+	Game(const Size& size, uint32_t mines) : Game(size, mines, Random::GenerateSeed()) { }
+	// 同じシードで同じセルを最初に開けば、同じ配置の地雷が置かれる
+	// 盤面と作業用の領域は、同じスレッドで以前に破棄された同じセル数の Game のものがあれば再利用する
+	Game(const Size& size, uint32_t mines, uint64_t seed);
+	Game(Game&&) = default;
+	Game& operator =(Game&&) = default;
+	~Game();
+
+	// 呼び出したスレッドが再利用のために保持している領域をすべて解放する（Game を作るスレッドを終えるときに呼ぶ）
+	static void ClearBufferPool();
+	// 扱える盤面の最大の大きさ（記録の読み込みやサーバーの新しいセッションもこれを超える盤面を受け付けない）
+	constexpr static Size MaximumSize = Size(10000, 10000);
+	// セル数がこれ以下の盤面では、作業用の領域をセル数から決まる上限まで最初に確保し、プレイ中に確保し直さない
+	constexpr static size_t MaximumPreallocatedCells = size_t(1) << 20;
+
+	// クエリ
+	constexpr const Size& GetSize() const { return m_Size; }
+	constexpr uint32_t GetMines() const { return m_Mines; }
+	constexpr uint64_t GetSeed() const { return m_Seed; }
+	constexpr const Cell& GetCell(const Point& loc) const { return CellAt(loc); }
+	constexpr std::span<const Cell> GetCells() const { return Cells(); }
+	constexpr const std::optional<Point>& GetOpeningPosition() const { return m_OpeningPosition; }
+	constexpr bool IsOpeningAnyCell() const { return m_OpeningPosition.has_value(); }
+	constexpr const Rect& GetViewport() const { return m_Viewport; }
+	constexpr bool ShouldRender() const { return m_ShouldRender; }
+	constexpr bool HasPlacedMines() const { return m_MinesToBePlaced == 0; }
+	constexpr GameProgress GetProgress() const
+	{
+		// 地雷が 1 つでも開かれていれば失敗、地雷のないセルがすべて開かれていれば完了
+		if (m_HasMineExploded)
+			return GameProgress::Failed;
+		if (m_OpenedSafeCells == Cells().size() - m_Mines)
+			return GameProgress::Completed;
+		return GameProgress::InProgress;
+	}
+	constexpr int32_t CountUnflaggedMines() const { return static_cast<int32_t>(static_cast<int64_t>(m_Mines) - static_cast<int64_t>(m_FlaggedCells)); }
+	constexpr bool IsHistoryEnabled() const { return m_History.IsEnabled(); }
+	constexpr bool CanUndo() const { return m_History.GetPosition() > 0; }
+	constexpr bool CanRedo() const { return m_History.GetPosition() < m_History.GetCount(); }
+	// 適用済みの操作の数（RewindHistory に渡すと、その時点の盤面に戻せる）
+	constexpr size_t GetHistoryPosition() const { return m_History.GetPosition(); }
+	constexpr const GameHistory& GetHistory() const { return m_History; }
+	constexpr static bool IsAround(const Point& loc, const Point& center) { return loc != center && loc.X + 1 >= center.X && loc.X <= center.X + 1 && loc.Y + 1 >= center.Y && loc.Y <= center.Y + 1; }
+
+	// コマンド
+	void Render(GameRenderer& renderer);
+	// まだ置かれていない地雷を without とその周囲を避けて置く（通常は最初に開いたセルに対して OpenCell から呼ばれる）
+	void PlaceMines(const Point& without);
+	// まだ置かれていない地雷を mineIndices のセルに置く（セル番号は行優先、重複のないこと）
+	void PlaceMines(std::span<const size_t> mineIndices);
+	// 同じ大きさと地雷数で新しいゲームを始める（盤面のメモリは再利用する）
+	void Reset() { Reset(m_Seed); }
+	void Reset(uint64_t seed);
+	// 開いたセルの数を返す
+	size_t OpenCell(const Point& loc);
+	size_t OpenCellsWithMineIndicator(const Point& loc);
+	void SwitchFlaggedState(const Point& loc);
+	// 有効にすると、盤面を変化させた操作を 1 つずつ取り消し・やり直しできる（地雷の配置は取り消さない）
+	// 無効にすると記録を破棄する。Reset でも記録は破棄される
+	void SetIsHistoryEnabled(bool value);
+	// 変化したセルだけを戻すので、盤面を複製せずに探索の分岐と後戻りに使える
+	bool Undo();
+	bool Redo();
+	// position 以前に操作を取り消した状態に戻す
+	void RewindHistory(size_t position);
+	constexpr void SetCellOpening(const Point& loc)
+	{
+		if (m_OpeningPosition == loc)
+			return;
+		ClearCellOpening();
+		m_OpeningPosition = loc;
+		InvalidateAround(loc);
+	}
+	constexpr void ClearCellOpening()
+	{
+		if (!m_OpeningPosition)
+			return;
+		InvalidateAround(*m_OpeningPosition);
+		m_OpeningPosition = std::nullopt;
+	}
+	// 次回の描画で表示範囲内のすべてのセルを再描画させる
+	constexpr void InvalidateAll()
+	{
+		m_ShouldRenderAll = true;
+		m_ShouldRender = true;
+	}
+	// 描画するセルの範囲を設定する（変化したセルの記録も表示範囲内に限られる）
+	void SetViewport(const Rect& viewport);
+
+private:
+	friend class GameSnapshot;
+
+	// 写像したファイルなど Game 以外が確保した領域のセルを使う場合は、Owner がその領域を保持する
+	struct CellDeleter
+	{
+		std::shared_ptr<void> Owner;
+
+		void operator ()(Cell* cells) const
+		{
+			if (!Owner)
+				delete[] cells;
+		}
+	};
+	using CellArray = std::unique_ptr<Cell[], CellDeleter>;
+	// Game を破棄した後も同じセル数の Game で再利用する領域
+	struct Buffers
+	{
+		std::unique_ptr<Cell[]> Cells;
+		GameHistory History;
+		std::vector<Point> SearchLocations;
+		std::vector<Point> DirtyLocations;
+		std::vector<bool> DirtyFlags;
+		std::vector<size_t> MineIndices;
+		std::vector<uint8_t> RowSums;
+	};
+	struct BufferPool;
+
+	// cells は size のセル数だけの要素を持つこと
+	Game(const Size& size, uint32_t mines, uint64_t seed, CellArray cells) :
+		m_Cells(std::move(cells)),
+		m_Size(size),
+		m_Mines(mines),
+		m_MinesToBePlaced(mines),
+		m_Seed(seed),
+		m_Random(seed),
+		m_OpenedSafeCells(0),
+		m_FlaggedCells(0),
+		m_HasMineExploded(false),
+		m_Viewport(Point(), size),
+		m_ShouldRenderAll(true),
+		m_ShouldRender(true)
+	{
+		if (mines >= Cells().size())
+			throw std::invalid_argument("The number of mines must be less than the number of cells.");
+	}
+	Game(const Size& size, uint32_t mines, uint64_t seed, Buffers&& buffers);
+
+	// スレッドの終了処理で既に破棄されていれば nullptr を返す
+	static BufferPool* GetBufferPool();
+	// セルをすべて初期状態にした領域を返す
+	static Buffers AcquireBuffers(const Size& size);
+	void ReleaseBuffers();
+
+	// 地雷数がセル数のこの値分の 1 未満であれば周囲の地雷数を地雷側からの加算で求める
+	constexpr static size_t ScatterDensityDivisor = 13;
+
+	constexpr Cell& CellAt(uint32_t x, uint32_t y) { return m_Cells[static_cast<size_t>(y) * m_Size.Width + x]; }
+	constexpr const Cell& CellAt(uint32_t x, uint32_t y) const { return m_Cells[static_cast<size_t>(y) * m_Size.Width + x]; }
+	constexpr Cell& CellAt(const Point& loc) { return CellAt(loc.X, loc.Y); }
+	constexpr const Cell& CellAt(const Point& loc) const { return CellAt(loc.X, loc.Y); }
+	constexpr std::span<Cell> Cells() { return std::span<Cell>(m_Cells.get(), static_cast<size_t>(m_Size.Width) * m_Size.Height); }
+	constexpr std::span<const Cell> Cells() const { return std::span<const Cell>(m_Cells.get(), static_cast<size_t>(m_Size.Width) * m_Size.Height); }
+
+	void CountAroundMines(std::span<const size_t> mineIndices);
+	// 記録を確定しない OpenCell
+	size_t Open(const Point& loc);
+	constexpr void OpenAllMines()
+	{
+		for (const auto& loc : AllPointView(m_Size))
+		{
+			auto& cell = CellAt(loc);
+			if (cell.HasMine && cell.State != CellState::Open)
+			{
+				if (cell.State == CellState::Flagged)
+					m_FlaggedCells--;
+				m_History.Record(IndexOf(loc), cell.State, CellState::Open);
+				cell.State = CellState::Open;
+				Invalidate(loc);
+			}
+		}
+	}
+	// 記録した範囲のセルの状態を戻すかやり直し、カウンターを合わせる
+	void ApplyHistory(size_t index, bool undo);
+	// 前回の描画以降に表示が変化したセルとして記録する
+	constexpr void Invalidate(const Point& loc)
+	{
+		m_ShouldRender = true;
+		if (m_ShouldRenderAll || !m_Viewport.Contains(loc))
+			return;
+		const auto index = static_cast<size_t>(loc.Y - m_Viewport.Y) * m_Viewport.Width + (loc.X - m_Viewport.X);
+		if (m_DirtyFlags[index])
+			return;
+		// 表示範囲の大部分が変化した場合は個別に記録せず全体を再描画する
+		if (m_DirtyLocations.size() >= m_DirtyFlags.size() / 4)
+		{
+			m_ShouldRenderAll = true;
+			return;
+		}
+		m_DirtyFlags[index] = true;
+		m_DirtyLocations.emplace_back(loc);
+	}
+	constexpr void InvalidateAround(const Point& center)
+	{
+		for (auto pos : AroundPointView(center, m_Size))
+			Invalidate(pos);
+	}
+	constexpr size_t IndexOf(const Point& loc) const { return static_cast<size_t>(loc.Y) * m_Size.Width + loc.X; }
+
+	CellArray m_Cells;
+	Size m_Size;
+	uint32_t m_Mines;
+	uint32_t m_MinesToBePlaced;
+	uint64_t m_Seed;
+	Random m_Random;
+	size_t m_OpenedSafeCells;
+	size_t m_FlaggedCells;
+	bool m_HasMineExploded;
+	GameHistory m_History;
+	std::optional<Point> m_OpeningPosition;
+	Rect m_Viewport;
+	std::vector<Point> m_SearchLocations;
+	std::vector<Point> m_DirtyLocations;
+	std::vector<bool> m_DirtyFlags;
+	std::vector<size_t> m_MineIndices;
+	std::vector<uint8_t> m_RowSums;
+	bool m_ShouldRenderAll;
+	bool m_ShouldRender;
+};
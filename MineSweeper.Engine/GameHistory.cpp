@@ -0,0 +1,77 @@
+﻿#include <algorithm>
+#include <array>
+#include <bit>
+#include <utility>
+#include "GameHistory.h"
+
+void GameHistory::Commit(bool hasMineExplodedBefore, bool hasMineExplodedAfter)
+{
+	if (m_Changes.empty())
+		return;
+	m_Entries.resize(m_Position);
+	m_Runs.resize(m_Entries.empty() ? 0 : m_Entries.back().RunsEnd);
+	// 開いた順に記録された変化をセル番号の順に並べ、隣り合い前後の状態が同じものを 1 つの範囲にまとめる
+	SortChanges();
+	const auto begin = m_Runs.size();
+	constexpr uint64_t StateMask = (1 << StateBits) - 1;
+	for (const auto change : m_Changes)
+	{
+		const auto index = static_cast<size_t>(change >> StateBits * 2);
+		const auto before = static_cast<CellState>(change >> StateBits & StateMask);
+		const auto after = static_cast<CellState>(change & StateMask);
+		if (m_Runs.size() > begin)
+		{
+			auto& last = m_Runs.back();
+			if (last.Start + last.Length == index && last.Before == before && last.After == after)
+			{
+				last.Length++;
+				continue;
+			}
+		}
+		m_Runs.push_back({ index, 1, before, after });
+	}
+	m_Changes.clear();
+	m_Entries.push_back({ m_Runs.size(), hasMineExplodedBefore, hasMineExplodedAfter });
+	m_Position = m_Entries.size();
+}
+
+// 同じセルは 1 回しか記録されないので、状態を含めた整数全体の順はセル番号の順と一致する
+void GameHistory::SortChanges()
+{
+	if (m_Changes.size() < RadixSortThreshold)
+	{
+		std::ranges::sort(m_Changes);
+		return;
+	}
+	// 下位の桁から安定に並べ替える（桁数は最大のセル番号までに限る）
+	constexpr size_t Buckets = size_t(1) << RadixBits;
+	const auto bits = static_cast<uint32_t>(std::bit_width(std::ranges::max(m_Changes)));
+	m_SortBuffer.resize(m_Changes.size());
+	for (uint32_t shift = 0; shift < bits; shift += RadixBits)
+	{
+		std::array<size_t, Buckets> offsets{};
+		for (const auto change : m_Changes)
+			offsets[change >> shift & (Buckets - 1)]++;
+		size_t total = 0;
+		for (auto& offset : offsets)
+			total += std::exchange(offset, total);
+		for (const auto change : m_Changes)
+			m_SortBuffer[offsets[change >> shift & (Buckets - 1)]++] = change;
+		m_Changes.swap(m_SortBuffer);
+	}
+}
+
+void GameHistory::Clear()
+{
+	m_Position = 0;
+	m_Runs.clear();
+	m_Entries.clear();
+	m_Changes.clear();
+}
+
+void GameHistory::Reserve(size_t changes)
+{
+	m_Changes.reserve(changes);
+	m_SortBuffer.reserve(changes);
+	m_Runs.reserve(changes);
+}
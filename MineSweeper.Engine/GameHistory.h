@@ -0,0 +1,82 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+enum class CellState : uint8_t;
+
+// 操作ごとに状態が変化したセルだけを、セル番号が連続し変化の前後が同じ範囲にまとめて記録する
+// 記録と取り消しにかかる時間とメモリは、盤面の大きさではなく変化したセルの範囲の数に比例する
+class GameHistory
+{
+public:
+	struct Run
+	{
+		size_t Start;
+		uint32_t Length;
+		CellState Before;
+		CellState After;
+	};
+
+	GameHistory() : m_IsEnabled(false), m_Position(0) { }
+
+	constexpr bool IsEnabled() const { return m_IsEnabled; }
+	// 無効にすると記録をすべて破棄する
+	void SetEnabled(bool value)
+	{
+		m_IsEnabled = value;
+		if (!value)
+			Clear();
+	}
+	// 適用済みの操作の数（これより後の操作はやり直しの対象）
+	constexpr size_t GetPosition() const { return m_Position; }
+	constexpr size_t GetCount() const { return m_Entries.size(); }
+	constexpr void SetPosition(size_t position) { m_Position = position; }
+	std::span<const Run> GetRuns(size_t index) const
+	{
+		const auto begin = index > 0 ? m_Entries[index - 1].RunsEnd : 0;
+		return std::span<const Run>(m_Runs).subspan(begin, m_Entries[index].RunsEnd - begin);
+	}
+	constexpr bool HasMineExplodedBefore(size_t index) const { return m_Entries[index].HasMineExplodedBefore; }
+	constexpr bool HasMineExplodedAfter(size_t index) const { return m_Entries[index].HasMineExplodedAfter; }
+	// 記録に使っているおおよそのバイト数
+	constexpr size_t GetMemoryUsage() const { return m_Runs.size() * sizeof(Run) + m_Entries.size() * sizeof(Entry); }
+
+	// 1 つの操作の中で同じセルを 2 回以上記録しないこと
+	void Record(size_t index, CellState before, CellState after)
+	{
+		if (m_IsEnabled)
+			m_Changes.push_back(static_cast<uint64_t>(index) << StateBits * 2 | static_cast<uint64_t>(before) << StateBits | static_cast<uint64_t>(after));
+	}
+	// Record で記録した変化を 1 つの操作として確定し、やり直しの対象だった操作を破棄する（変化がなければ何もしない）
+	void Commit(bool hasMineExplodedBefore, bool hasMineExplodedAfter);
+	void Clear();
+	// 1 つの操作で changes 個までのセルが変化しても、記録のために確保し直さないようにする
+	void Reserve(size_t changes);
+
+private:
+	struct Entry
+	{
+		// この操作の範囲が m_Runs のどこまでか
+		size_t RunsEnd;
+		bool HasMineExplodedBefore;
+		bool HasMineExplodedAfter;
+	};
+
+	// 未確定の変化はセル番号と変化の前後の状態を 1 つの整数に詰めて並べ、セル番号の順に基数ソートする
+	constexpr static uint32_t StateBits = 2;
+	constexpr static uint32_t RadixBits = 11;
+	// これより変化が少なければ比較によるソートを使う
+	constexpr static size_t RadixSortThreshold = 1024;
+
+	bool m_IsEnabled;
+	size_t m_Position;
+	std::vector<Run> m_Runs;
+	std::vector<Entry> m_Entries;
+	std::vector<uint64_t> m_Changes;
+	std::vector<uint64_t> m_SortBuffer;
+
+	void SortChanges();
+};
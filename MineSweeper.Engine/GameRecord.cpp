@@ -0,0 +1,198 @@
+﻿#include <algorithm>
+#include <stdexcept>
+#include "GameRecord.h"
+
+namespace
+{
+	constexpr uint8_t Magic[] = { 'M', 'S', 'R', 'C' };
+	constexpr uint8_t Version = 1;
+	constexpr uint8_t HasMineIndicesFlag = 1;
+	// 操作の種類は位置の横方向の差分と同じ可変長整数の下位ビットに格納する
+	constexpr uint32_t KindBits = 2;
+
+	constexpr uint64_t ZigZagEncode(int64_t value) { return static_cast<uint64_t>(value) << 1 ^ static_cast<uint64_t>(value >> 63); }
+	constexpr int64_t ZigZagDecode(uint64_t value) { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+
+	class Writer
+	{
+	public:
+		void WriteByte(uint8_t value) { m_Data.emplace_back(value); }
+		void WriteVarint(uint64_t value)
+		{
+			while (value >= 0x80)
+			{
+				m_Data.emplace_back(static_cast<uint8_t>(value | 0x80));
+				value >>= 7;
+			}
+			m_Data.emplace_back(static_cast<uint8_t>(value));
+		}
+		std::vector<uint8_t> GetData() && { return std::move(m_Data); }
+
+	private:
+		std::vector<uint8_t> m_Data;
+	};
+
+	class Reader
+	{
+	public:
+		explicit Reader(std::span<const uint8_t> data) : m_Data(data), m_Position(0) { }
+
+		uint8_t ReadByte()
+		{
+			if (m_Position >= m_Data.size())
+				throw std::invalid_argument("The game record is truncated.");
+			return m_Data[m_Position++];
+		}
+		uint64_t ReadVarint()
+		{
+			uint64_t value = 0;
+			for (uint32_t shift = 0; shift < 64; shift += 7)
+			{
+				const auto byte = ReadByte();
+				value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+				if (!(byte & 0x80))
+					return value;
+			}
+			throw std::invalid_argument("The game record contains an overlong integer.");
+		}
+		uint32_t ReadVarint32()
+		{
+			const auto value = ReadVarint();
+			if (value > UINT32_MAX)
+				throw std::invalid_argument("The game record contains an out-of-range integer.");
+			return static_cast<uint32_t>(value);
+		}
+		bool IsAtEnd() const { return m_Position == m_Data.size(); }
+		size_t GetRemaining() const { return m_Data.size() - m_Position; }
+
+	private:
+		std::span<const uint8_t> m_Data;
+		size_t m_Position;
+	};
+}
+
+void GameRecord::SetMineIndices(const Game& game)
+{
+	m_MineIndices.clear();
+	const auto cells = game.GetCells();
+	for (size_t i = 0; i < cells.size(); i++)
+	{
+		if (cells[i].HasMine)
+			m_MineIndices.emplace_back(i);
+	}
+}
+
+std::vector<uint8_t> GameRecord::Serialize() const
+{
+	Writer writer;
+	for (auto byte : Magic)
+		writer.WriteByte(byte);
+	writer.WriteByte(Version);
+	writer.WriteByte(m_MineIndices.empty() ? 0 : HasMineIndicesFlag);
+	writer.WriteVarint(m_Size.Width);
+	writer.WriteVarint(m_Size.Height);
+	writer.WriteVarint(m_Mines);
+	writer.WriteVarint(m_Seed);
+	// 地雷の配置は昇順のセル番号の差分で格納する
+	if (!m_MineIndices.empty())
+	{
+		size_t previous = 0;
+		for (auto index : m_MineIndices)
+		{
+			writer.WriteVarint(index - previous);
+			previous = index;
+		}
+	}
+	writer.WriteVarint(m_Actions.size());
+	Point previousLocation;
+	std::chrono::milliseconds previousTime(0);
+	for (const auto& action : m_Actions)
+	{
+		const auto delta = action.Location - previousLocation;
+		writer.WriteVarint(ZigZagEncode(delta.X) << KindBits | static_cast<uint8_t>(action.Kind));
+		writer.WriteVarint(ZigZagEncode(delta.Y));
+		writer.WriteVarint(static_cast<uint64_t>(std::max(action.Time - previousTime, std::chrono::milliseconds(0)).count()));
+		previousLocation = action.Location;
+		previousTime = std::max(action.Time, previousTime);
+	}
+	return std::move(writer).GetData();
+}
+
+GameRecord GameRecord::Deserialize(std::span<const uint8_t> data)
+{
+	Reader reader(data);
+	for (auto byte : Magic)
+	{
+		if (reader.ReadByte() != byte)
+			throw std::invalid_argument("The data is not a game record.");
+	}
+	if (reader.ReadByte() != Version)
+		throw std::invalid_argument("The game record version is not supported.");
+	const auto flags = reader.ReadByte();
+	const auto width = reader.ReadVarint32();
+	const auto height = reader.ReadVarint32();
+	const auto mines = reader.ReadVarint32();
+	const auto cells = static_cast<uint64_t>(width) * height;
+	if (cells == 0 || width > Game::MaximumSize.Width || height > Game::MaximumSize.Height || mines >= cells)
+		throw std::invalid_argument("The game record has an invalid board.");
+	GameRecord record(Size(width, height), mines, reader.ReadVarint());
+	if (flags & HasMineIndicesFlag)
+	{
+		// 地雷の位置は 1 つあたり少なくとも 1 バイトなので、残りのデータより多い数は壊れている
+		if (mines > reader.GetRemaining())
+			throw std::invalid_argument("The game record is truncated.");
+		record.m_MineIndices.resize(mines);
+		uint64_t index = 0;
+		for (uint32_t i = 0; i < mines; i++)
+		{
+			const auto delta = reader.ReadVarint();
+			index += delta;
+			if ((i > 0 && delta == 0) || index >= cells)
+				throw std::invalid_argument("The game record has an invalid mine layout.");
+			record.m_MineIndices[i] = static_cast<size_t>(index);
+		}
+	}
+	const auto count = reader.ReadVarint();
+	// 1 操作は少なくとも 3 バイトなので、残りのデータより多い数は壊れている
+	if (count > data.size() / 3)
+		throw std::invalid_argument("The game record is truncated.");
+	record.m_Actions.reserve(static_cast<size_t>(count));
+	Point location;
+	std::chrono::milliseconds time(0);
+	for (uint64_t i = 0; i < count; i++)
+	{
+		const auto head = reader.ReadVarint();
+		const auto kind = static_cast<GameActionKind>(head & ((1 << KindBits) - 1));
+		if (kind > GameActionKind::OpenAround)
+			throw std::invalid_argument("The game record has an invalid action.");
+		const auto x = static_cast<int64_t>(location.X) + ZigZagDecode(head >> KindBits);
+		const auto y = static_cast<int64_t>(location.Y) + ZigZagDecode(reader.ReadVarint());
+		if (x < 0 || x >= width || y < 0 || y >= height)
+			throw std::invalid_argument("The game record has an action outside the board.");
+		location = Point(static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+		time += std::chrono::milliseconds(reader.ReadVarint());
+		record.m_Actions.emplace_back(kind, location, time);
+	}
+	if (!reader.IsAtEnd())
+		throw std::invalid_argument("The game record has trailing data.");
+	return record;
+}
+
+GameProgress GameRecord::Replay(Game& game) const
+{
+	if (game.GetSize() != m_Size || game.GetMines() != m_Mines)
+		throw std::invalid_argument("The game does not match the size and mines of the record.");
+	game.Reset(m_Seed);
+	if (!m_MineIndices.empty())
+		game.PlaceMines(m_MineIndices);
+	for (const auto& action : m_Actions)
+	{
+		switch (action.Kind)
+		{
+		case GameActionKind::Open      : game.OpenCell(action.Location); break;
+		case GameActionKind::SwitchFlag: game.SwitchFlaggedState(action.Location); break;
+		case GameActionKind::OpenAround: game.OpenCellsWithMineIndicator(action.Location); break;
+		}
+	}
+	return game.GetProgress();
+}
@@ -0,0 +1,67 @@
+﻿#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Game.h"
+
+enum class GameActionKind : uint8_t
+{
+	Open = 0,
+	SwitchFlag = 1,
+	OpenAround = 2,
+};
+
+struct GameAction
+{
+	constexpr GameAction() : Kind(GameActionKind::Open), Location(), Time(0) { }
+	constexpr GameAction(GameActionKind kind, const Point& location, std::chrono::milliseconds time) : Kind(kind), Location(location), Time(time) { }
+
+	GameActionKind Kind;
+	Point Location;
+	// ゲーム開始からの経過時間
+	std::chrono::milliseconds Time;
+
+	constexpr bool operator ==(const GameAction& right) const { return Kind == right.Kind && Location == right.Location && Time == right.Time; }
+	constexpr bool operator !=(const GameAction& right) const { return !(*this == right); }
+};
+
+// 盤面の大きさ・地雷数・シード（または地雷の配置）と、プレイヤーの操作の列
+// バイナリ形式では整数を可変長で、操作の位置と時刻を直前の操作からの差分で格納する（1 操作あたり 3〜5 バイト程度）
+class GameRecord
+{
+public:
+	GameRecord(const Size& size, uint32_t mines, uint64_t seed) : m_Size(size), m_Mines(mines), m_Seed(seed) { }
+
+	constexpr const Size& GetSize() const { return m_Size; }
+	constexpr uint32_t GetMines() const { return m_Mines; }
+	constexpr uint64_t GetSeed() const { return m_Seed; }
+	constexpr void SetSeed(uint64_t seed) { m_Seed = seed; }
+	constexpr std::span<const GameAction> GetActions() const { return m_Actions; }
+	// 空でなければ、シードの代わりにこの配置で地雷を置いて再生する
+	constexpr std::span<const size_t> GetMineIndices() const { return m_MineIndices; }
+
+	void AddAction(const GameAction& action) { m_Actions.emplace_back(action); }
+	// 取り消された操作を除く
+	void RemoveLastAction() { m_Actions.pop_back(); }
+	void ClearActions() { m_Actions.clear(); }
+	// game に置かれている地雷の配置を記録する
+	void SetMineIndices(const Game& game);
+
+	std::vector<uint8_t> Serialize() const;
+	// 形式が正しくなければ std::invalid_argument を送出する
+	static GameRecord Deserialize(std::span<const uint8_t> data);
+
+	// game を記録の最初の状態からやり直して操作をすべて適用し、結果を返す（game は同じ大きさと地雷数であること）
+	GameProgress Replay(Game& game) const;
+	Game CreateGame() const { return Game(m_Size, m_Mines, m_Seed); }
+
+private:
+	Size m_Size;
+	uint32_t m_Mines;
+	uint64_t m_Seed;
+	std::vector<GameAction> m_Actions;
+	std::vector<size_t> m_MineIndices;
+};
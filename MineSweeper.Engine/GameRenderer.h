@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include "Geometry.h"
+
+class Cell;
+
+class GameRenderer
+{
+public:
+	GameRenderer() = default;
+	GameRenderer(const GameRenderer&) = delete;
+	GameRenderer& operator=(const GameRenderer&) = delete;
+	virtual ~GameRenderer() = default;
+
+	virtual void BeginFrame() = 0;
+	virtual void RenderCell(const Point& loc, const Cell& cell, bool opening) = 0;
+	virtual void RenderMineCounter(int32_t unflaggedMines) = 0;
+	virtual void EndFrame() = 0;
+};
@@ -0,0 +1,229 @@
+﻿#include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "Game.h"
+#include "GameServer.h"
+
+namespace
+{
+	// 空白で区切られた次の語を取り出す
+	std::string_view NextToken(std::string_view& text)
+	{
+		const auto begin = std::min(text.find_first_not_of(" \t\r\n"), text.size());
+		const auto end = std::min(text.find_first_of(" \t\r\n", begin), text.size());
+		const auto token = text.substr(begin, end - begin);
+		text.remove_prefix(end);
+		return token;
+	}
+	template <typename T> bool ParseToken(std::string_view& text, T& value)
+	{
+		const auto token = NextToken(text);
+		const auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+		return !token.empty() && result.ec == std::errc() && result.ptr == token.data() + token.size();
+	}
+
+	constexpr const char* GetProgressName(GameProgress progress)
+	{
+		switch (progress)
+		{
+		case GameProgress::Completed: return "completed";
+		case GameProgress::Failed   : return "failed";
+		default                     : return "in_progress";
+		}
+	}
+}
+
+// 受け付けたコマンドを溜めておき、自分のスレッドでまとめて取り出して実行する
+class GameServer::Worker
+{
+public:
+	explicit Worker(const GameServer& server) : m_Server(server), m_IsStopping(false), m_Thread([this]() { Run(); }) { }
+	~Worker()
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+			m_IsStopping = true;
+		}
+		m_Condition.notify_one();
+	}
+
+	void Push(const Command& command)
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+			m_Queue.push_back(command);
+		}
+		m_Condition.notify_one();
+	}
+
+private:
+	const GameServer& m_Server;
+	std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+	std::vector<Command> m_Queue;
+	bool m_IsStopping;
+	std::unordered_map<uint64_t, Game> m_Sessions;
+	// 他のメンバーを初期化してからスレッドを始め、破棄するときは最初に終了を待つ
+	std::jthread m_Thread;
+
+	void Run()
+	{
+		std::vector<Command> batch;
+		while (true)
+		{
+			{
+				std::unique_lock lock(m_Mutex);
+				m_Condition.wait(lock, [this]() { return m_IsStopping || !m_Queue.empty(); });
+				if (m_Queue.empty())
+					break;
+				batch.swap(m_Queue);
+			}
+			for (const auto& command : batch)
+				Execute(command);
+			batch.clear();
+			if (m_Server.m_Flush)
+				m_Server.m_Flush();
+		}
+		// 残ったセッションはこのスレッドで破棄し、保持した盤面も解放してから終える
+		m_Sessions.clear();
+		Game::ClearBufferPool();
+	}
+	void Execute(const Command& command)
+	{
+		char buffer[96];
+		if (command.Kind == CommandKind::New)
+		{
+			try
+			{
+				// 取り消しに備えて操作を記録する
+				m_Sessions.try_emplace(command.Session, command.Size, command.Mines, command.Seed).first->second.SetIsHistoryEnabled(true);
+			}
+			catch (const std::exception& e)
+			{
+				m_Server.Reply(command.Tag, e.what());
+				return;
+			}
+			Reply(buffer, std::snprintf(buffer, sizeof(buffer), "%llu ok %llu", static_cast<unsigned long long>(command.Tag), static_cast<unsigned long long>(command.Session)));
+			return;
+		}
+		const auto it = m_Sessions.find(command.Session);
+		if (it == m_Sessions.end())
+		{
+			m_Server.Reply(command.Tag, "unknown session");
+			return;
+		}
+		auto& game = it->second;
+		if (command.Kind == CommandKind::Close)
+		{
+			m_Sessions.erase(it);
+			Reply(buffer, std::snprintf(buffer, sizeof(buffer), "%llu ok", static_cast<unsigned long long>(command.Tag)));
+			return;
+		}
+		if (command.Kind == CommandKind::Undo)
+		{
+			const bool undone = game.Undo();
+			Reply(buffer, std::snprintf(buffer, sizeof(buffer), "%llu ok %d %s", static_cast<unsigned long long>(command.Tag), undone ? 1 : 0, GetProgressName(game.GetProgress())));
+			return;
+		}
+		if (!command.Location.IsContainedIn(game.GetSize()))
+		{
+			m_Server.Reply(command.Tag, "location out of range");
+			return;
+		}
+		if (game.GetProgress() != GameProgress::InProgress)
+		{
+			m_Server.Reply(command.Tag, "game is over");
+			return;
+		}
+		long long value;
+		switch (command.Kind)
+		{
+		case CommandKind::Open : value = static_cast<long long>(game.OpenCell(command.Location)); break;
+		case CommandKind::Chord: value = static_cast<long long>(game.OpenCellsWithMineIndicator(command.Location)); break;
+		default:
+			game.SwitchFlaggedState(command.Location);
+			value = game.CountUnflaggedMines();
+			break;
+		}
+		Reply(buffer, std::snprintf(buffer, sizeof(buffer), "%llu ok %lld %s", static_cast<unsigned long long>(command.Tag), value, GetProgressName(game.GetProgress())));
+	}
+	void Reply(const char* buffer, int length) const { m_Server.m_Reply(std::string_view(buffer, static_cast<size_t>(length))); }
+};
+
+GameServer::GameServer(uint32_t threads, ReplyHandler reply, FlushHandler flush) : m_Reply(std::move(reply)), m_Flush(std::move(flush)), m_NextSession(1)
+{
+	const auto count = threads > 0 ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+	m_Workers.reserve(count);
+	for (uint32_t i = 0; i < count; i++)
+		m_Workers.emplace_back(std::make_unique<Worker>(*this));
+}
+
+GameServer::~GameServer() { m_Workers.clear(); }
+
+void GameServer::Submit(std::string_view line)
+{
+	Command command{};
+	if (!ParseToken(line, command.Tag))
+	{
+		Reply(0, "invalid tag");
+		return;
+	}
+	const auto name = NextToken(line);
+	bool valid;
+	if (name == "new")
+	{
+		command.Kind = CommandKind::New;
+		valid = ParseToken(line, command.Size.Width) && ParseToken(line, command.Size.Height) && ParseToken(line, command.Mines);
+		// シードを省略した場合は新たに作る
+		if (auto rest = line; valid && !NextToken(rest).empty())
+			valid = ParseToken(line, command.Seed);
+		else
+			command.Seed = Random::GenerateSeed();
+		if (valid && (command.Size.Width == 0 || command.Size.Height == 0 || command.Size.Width > MaximumSize.Width || command.Size.Height > MaximumSize.Height))
+		{
+			Reply(command.Tag, "invalid size");
+			return;
+		}
+		if (valid)
+			command.Session = m_NextSession.fetch_add(1, std::memory_order_relaxed);
+	}
+	else
+	{
+		if (name == "open")
+			command.Kind = CommandKind::Open;
+		else if (name == "chord")
+			command.Kind = CommandKind::Chord;
+		else if (name == "flag")
+			command.Kind = CommandKind::Flag;
+		else if (name == "undo")
+			command.Kind = CommandKind::Undo;
+		else if (name == "close")
+			command.Kind = CommandKind::Close;
+		else
+		{
+			Reply(command.Tag, "unknown command");
+			return;
+		}
+		valid = ParseToken(line, command.Session);
+		if (valid && command.Kind != CommandKind::Undo && command.Kind != CommandKind::Close)
+			valid = ParseToken(line, command.Location.X) && ParseToken(line, command.Location.Y);
+	}
+	if (!valid || !NextToken(line).empty())
+	{
+		Reply(command.Tag, "invalid arguments");
+		return;
+	}
+	m_Workers[command.Session % m_Workers.size()]->Push(command);
+}
+
+void GameServer::Reply(uint64_t tag, std::string_view error) const
+{
+	char buffer[128];
+	const auto length = std::snprintf(buffer, sizeof(buffer), "%llu error %.*s", static_cast<unsigned long long>(tag), static_cast<int>(error.size()), error.data());
+	m_Reply(std::string_view(buffer, static_cast<size_t>(std::min<int>(length, sizeof(buffer) - 1))));
+}
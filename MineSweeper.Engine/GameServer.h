@@ -0,0 +1,73 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "Game.h"
+#include "Geometry.h"
+
+// 多数のゲームを同時に保持し、1 行に 1 つのコマンドを書いた文字列で操作する
+// セッションはその番号で決まる 1 つのワーカースレッドだけが扱うので、同じセッションへのコマンドは受け付けた順に 1 つずつ実行される
+// ワーカーごとに受付の待ち行列を持ち、全体で共有するロックはない
+//
+// <tag> は応答の先頭にそのまま付けて返す 64 ビットの符号なし整数
+//   <tag> new <幅> <高さ> <地雷数> [シード] → <tag> ok <セッション>
+//   <tag> open <セッション> <x> <y>         → <tag> ok <開いたセルの数> <進行状況>
+//   <tag> chord <セッション> <x> <y>        → <tag> ok <開いたセルの数> <進行状況>
+//   <tag> flag <セッション> <x> <y>         → <tag> ok <残りの地雷数> <進行状況>
+//   <tag> undo <セッション>                 → <tag> ok <取り消した操作の数 (0 または 1)> <進行状況>
+//   <tag> close <セッション>                → <tag> ok
+// 進行状況は in_progress、completed、failed のいずれかで、失敗した場合は <tag> error <理由> を返す
+class GameServer
+{
+public:
+	using ReplyHandler = std::function<void(std::string_view)>;
+	using FlushHandler = std::function<void()>;
+
+	// threads が 0 のときはハードウェアのスレッド数にする。reply は応答ごとにワーカースレッドから並行して呼ばれる
+	// flush は各ワーカーが溜まっていたコマンドをすべて実行し終えるたびに、そのワーカースレッドから呼ばれる（応答をまとめて書き出すのに使う）
+	GameServer(uint32_t threads, ReplyHandler reply, FlushHandler flush = nullptr);
+	GameServer(const GameServer&) = delete;
+	GameServer& operator =(const GameServer&) = delete;
+	// 受け付けたコマンドをすべて実行してから終える
+	~GameServer();
+
+	size_t GetThreadCount() const { return m_Workers.size(); }
+	// どのスレッドからでも呼べる（行末の改行はあってもなくてもよい）
+	void Submit(std::string_view line);
+
+	// 1 つのセッションで扱える盤面の最大の大きさ
+	constexpr static Size MaximumSize = Game::MaximumSize;
+
+private:
+	enum class CommandKind : uint8_t
+	{
+		New,
+		Open,
+		Chord,
+		Flag,
+		Undo,
+		Close,
+	};
+	struct Command
+	{
+		uint64_t Tag;
+		CommandKind Kind;
+		uint64_t Session;
+		Point Location;
+		::Size Size;
+		uint32_t Mines;
+		uint64_t Seed;
+	};
+	class Worker;
+
+	ReplyHandler m_Reply;
+	FlushHandler m_Flush;
+	std::atomic<uint64_t> m_NextSession;
+	std::vector<std::unique_ptr<Worker>> m_Workers;
+
+	void Reply(uint64_t tag, std::string_view error) const;
+};
@@ -0,0 +1,114 @@
+﻿#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include "GameSnapshot.h"
+#include "MappedFile.h"
+
+namespace
+{
+	constexpr char Magic[8] = { 'M', 'S', 'S', 'N', 'A', 'P', '\r', '\n' };
+	constexpr uint32_t Version = 1;
+	// セル部はページ境界から始め、写像したまま Cell として使えるようにする
+	constexpr uint64_t CellOffset = 4096;
+
+	struct SnapshotHeader
+	{
+		char Magic[8];
+		uint32_t Version;
+		uint32_t CellSize;
+		uint32_t CellLayout;
+		uint32_t Width;
+		uint32_t Height;
+		uint32_t Mines;
+		uint32_t MinesToBePlaced;
+		uint32_t HasMineExploded;
+		uint64_t Seed;
+		uint64_t OpenedSafeCells;
+		uint64_t FlaggedCells;
+		uint64_t CellOffset;
+		uint64_t CellBytes;
+	};
+	static_assert(sizeof(SnapshotHeader) <= CellOffset);
+
+	// 各ビットフィールドに既知の値を入れたセルのバイト列（ビット配置やバイト順の異なる環境を見分ける）
+	uint32_t GetCellLayout()
+	{
+		Cell cell;
+		cell.AroundMines = 5;
+		cell.HasMine = true;
+		cell.State = CellState::Flagged;
+		uint32_t layout = 0;
+		std::memcpy(&layout, &cell, std::min(sizeof(cell), sizeof(layout)));
+		return layout;
+	}
+}
+
+void GameSnapshot::Save(const Game& game, const std::filesystem::path& path)
+{
+	const auto cells = game.Cells();
+	SnapshotHeader header{};
+	std::memcpy(header.Magic, Magic, sizeof(Magic));
+	header.Version = Version;
+	header.CellSize = sizeof(Cell);
+	header.CellLayout = GetCellLayout();
+	header.Width = game.m_Size.Width;
+	header.Height = game.m_Size.Height;
+	header.Mines = game.m_Mines;
+	header.MinesToBePlaced = game.m_MinesToBePlaced;
+	header.HasMineExploded = game.m_HasMineExploded;
+	header.Seed = game.m_Seed;
+	header.OpenedSafeCells = game.m_OpenedSafeCells;
+	header.FlaggedCells = game.m_FlaggedCells;
+	header.CellOffset = CellOffset;
+	header.CellBytes = cells.size_bytes();
+
+	auto temporaryPath = path;
+	temporaryPath += ".tmp";
+	std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+	char page[CellOffset]{};
+	std::memcpy(page, &header, sizeof(header));
+	stream.write(page, sizeof(page));
+	stream.write(reinterpret_cast<const char*>(cells.data()), static_cast<std::streamsize>(cells.size_bytes()));
+	stream.close();
+	if (!stream)
+	{
+		std::error_code error;
+		std::filesystem::remove(temporaryPath, error);
+		throw std::runtime_error("The snapshot could not be written.");
+	}
+	// 写像中のファイルを切り詰めると写像した側が読めなくなるので、書き換えずに置き換える
+	std::filesystem::rename(temporaryPath, path);
+}
+
+Game GameSnapshot::Load(const std::filesystem::path& path)
+{
+	const auto file = std::make_shared<MappedFile>(path);
+	const auto data = file->GetData();
+	SnapshotHeader header;
+	if (data.size() < sizeof(header))
+		throw std::invalid_argument("The file is not a snapshot.");
+	std::memcpy(&header, data.data(), sizeof(header));
+	if (std::memcmp(header.Magic, Magic, sizeof(Magic)) != 0)
+		throw std::invalid_argument("The file is not a snapshot.");
+	if (header.Version != Version)
+		throw std::invalid_argument("The snapshot version is not supported.");
+	if (header.CellSize != sizeof(Cell) || header.CellLayout != GetCellLayout())
+		throw std::invalid_argument("The snapshot was saved with a different cell layout.");
+	const auto cellCount = static_cast<uint64_t>(header.Width) * header.Height;
+	if (cellCount == 0 || header.Mines >= cellCount || (header.MinesToBePlaced != 0 && header.MinesToBePlaced != header.Mines) ||
+		header.OpenedSafeCells > cellCount - header.Mines || header.FlaggedCells > cellCount)
+		throw std::invalid_argument("The snapshot has an invalid state.");
+	if (header.CellOffset % alignof(Cell) != 0 || header.CellBytes != cellCount * sizeof(Cell) ||
+		header.CellOffset > data.size() || header.CellBytes > data.size() - header.CellOffset)
+		throw std::invalid_argument("The snapshot is truncated.");
+
+	// セルは写像した領域をそのまま指し、写像は Game がセルを手放すまで保たれる
+	Game::CellArray cells(reinterpret_cast<Cell*>(data.data() + header.CellOffset), Game::CellDeleter { file });
+	Game game(Size(header.Width, header.Height), header.Mines, header.Seed, std::move(cells));
+	game.m_MinesToBePlaced = header.MinesToBePlaced;
+	game.m_OpenedSafeCells = static_cast<size_t>(header.OpenedSafeCells);
+	game.m_FlaggedCells = static_cast<size_t>(header.FlaggedCells);
+	game.m_HasMineExploded = header.HasMineExploded != 0;
+	return game;
+}
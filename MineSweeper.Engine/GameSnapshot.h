@@ -0,0 +1,18 @@
+﻿#pragma once
+
+#include <filesystem>
+#include "Game.h"
+
+// ゲームの状態をそのままメモリに写像して使える形式で保存・読み込みする
+// 先頭のヘッダーに大きさ・地雷数・シード・カウンターを、ページ境界から始まるセル部に Cell の配列をそのまま格納する
+// セルのビット配置は処理系に依存するので、ヘッダーに記録した Cell の大きさと配置が一致しない環境では読み込めない
+class GameSnapshot
+{
+public:
+	// 別のファイルに書き込んでから path を置き換えるので、path を写像して読み込んだゲームをそのまま同じ path に保存できる
+	// 書き込めなければ std::runtime_error を送出する
+	static void Save(const Game& game, const std::filesystem::path& path);
+	// ファイルを写像してセル部を読み込み直さずに使うので、大きな盤面でも読み込みはヘッダーの検証だけで終わる
+	// 開けなければ std::system_error を、形式が正しくなければ std::invalid_argument を送出する
+	static Game Load(const std::filesystem::path& path);
+};
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <ranges>
+
+struct Vector
+{
+	constexpr Vector() : X(0), Y(0) {}
+	constexpr Vector(int32_t x, int32_t y) : X(x), Y(y) { }
+
+	int32_t X;
+	int32_t Y;
+
+	constexpr bool operator ==(const Vector& right) const { return X == right.X && Y == right.Y; }
+	constexpr bool operator !=(const Vector& right) const { return !(*this == right); }
+	constexpr Vector& operator +=(const Vector& right)
+	{
+		X += right.X;
+		Y += right.Y;
+		return *this;
+	}
+	constexpr Vector operator +(const Vector& right) const { return Vector(*this) += right; }
+	constexpr Vector& operator -=(const Vector& right)
+	{
+		X -= right.X;
+		Y -= right.Y;
+		return *this;
+	}
+	constexpr Vector operator -(const Vector& right) const { return Vector(*this) -= right; }
+	constexpr Vector operator +() const { return *this; }
+	constexpr Vector operator -() const { return { -X, -Y }; }
+};
+
+struct Size
+{
+	constexpr Size() : Width(0), Height(0) {}
+	constexpr Size(uint32_t width, uint32_t height) : Width(width), Height(height) {}
+	explicit Size(const Vector& vector) : Width(static_cast<uint32_t>(std::abs(vector.X))), Height(static_cast<uint32_t>(std::abs(vector.Y))) {}
+
+	uint32_t Width;
+	uint32_t Height;
+
+	constexpr bool operator ==(const Size& right) const { return Width == right.Width && Height == right.Height; }
+	constexpr bool operator !=(const Size& right) const { return !(*this == right); }
+	constexpr explicit operator Vector() const { return Vector(static_cast<int32_t>(Width), static_cast<int32_t>(Height)); }
+};
+
+struct Point
+{
+public:
+	constexpr Point() : X(0), Y(0) { }
+	constexpr Point(uint32_t x, uint32_t y) : X(x), Y(y) { }
+
+	uint32_t X;
+	uint32_t Y;
+
+	constexpr Point& operator +=(const Vector& right)
+	{
+		X += right.X;
+		Y += right.Y;
+		return *this;
+	}
+	constexpr Point operator +(const Vector& right) const { return Point(*this) += right; }
+	constexpr Point& operator -=(const Vector& right)
+	{
+		X -= right.X;
+		Y -= right.Y;
+		return *this;
+	}
+	constexpr Point operator -(const Vector& right) const { return Point(*this) -= right; }
+	constexpr Vector operator -(const Point& right) const { return Vector(SafeSubtract(X, right.X), SafeSubtract(Y, right.Y)); }
+	constexpr bool operator ==(const Point& right) const { return X == right.X && Y == right.Y; }
+	constexpr bool operator !=(const Point& right) const { return !(*this == right); }
+
+	constexpr bool IsContainedIn(const Size& size) const { return X < size.Width&& Y < size.Height; }
+
+private:
+	constexpr static int32_t SafeSubtract(uint32_t left, uint32_t right)
+	{
+		return left >= right ?
+			static_cast<int32_t>(left - right) :
+			-static_cast<int32_t>(right - left);
+	}
+};
+
+constexpr inline Point operator +(const Vector& left, const Point& right) { return right + left; }
+
+struct Rect
+{
+	constexpr Rect() : X(0), Y(0), Width(0), Height(0) { }
+	constexpr Rect(const Point& location, const Size& size) : X(location.X), Y(location.Y), Width(size.Width), Height(size.Height) { }
+
+	uint32_t X;
+	uint32_t Y;
+	uint32_t Width;
+	uint32_t Height;
+
+	constexpr Point GetLocation() const { return Point(X, Y); }
+	constexpr Size GetSize() const { return Size(Width, Height); }
+	constexpr bool operator ==(const Rect& right) const { return X == right.X && Y == right.Y && Width == right.Width && Height == right.Height; }
+	constexpr bool operator !=(const Rect& right) const { return !(*this == right); }
+
+	constexpr bool Contains(const Point& point) const { return point.X >= X && point.X - X < Width && point.Y >= Y && point.Y - Y < Height; }
+	constexpr bool IsContainedIn(const Size& size) const { return X <= size.Width && Width <= size.Width - X && Y <= size.Height && Height <= size.Height - Y; }
+};
+
+class AllPointView : public std::ranges::view_interface<AllPointView>
+{
+public:
+	class Sentinel {};
+	class Iterator
+	{
+	public:
+		constexpr Iterator(const Size& size) : m_Value(), m_Size(size) {}
+		constexpr Iterator& operator ++() { m_Value = m_Value.X >= m_Size.Width - 1 ? Point(0, m_Value.Y + 1) : Point(m_Value.X + 1, m_Value.Y); return *this; }
+		constexpr void operator ++(int) { operator ++(); }
+		constexpr const Point& operator *() const { return m_Value; }
+		constexpr bool operator ==(Sentinel) const { return !m_Value.IsContainedIn(m_Size); }
+
+		using difference_type = ptrdiff_t;
+		using value_type = Point;
+	private:
+		Point m_Value;
+		Size m_Size;
+	};
+
+	constexpr AllPointView(const Size& size) : m_Size(size) {}
+	constexpr Iterator begin() const { return Iterator(m_Size); }
+	constexpr Sentinel end() const { return {}; }
+
+private:
+	Size m_Size;
+};
+
+template <>
+inline constexpr bool std::ranges::enable_borrowed_range<AllPointView> = true;
+
+class AroundPointView : public std::ranges::view_interface<AroundPointView>
+{
+public:
+	class Sentinel {};
+	class Iterator
+	{
+	public:
+		constexpr Iterator(const Point& center, const Size& size) : m_Center(center), m_Size(size), m_Index(static_cast<uint32_t>(-1)) { operator ++(); }
+		constexpr Iterator& operator ++()
+		{
+			do
+				m_Index++;
+			while (m_Index < End && (m_Index == Skip || !operator *().IsContainedIn(m_Size)));
+			return *this;
+		}
+		constexpr void operator ++(int) { operator ++(); }
+		constexpr Point operator *() const { return m_Center + Vector(m_Index % 3 - 1, m_Index / 3 - 1); }
+		constexpr bool operator ==(Sentinel) const { return m_Index == End; }
+
+		using difference_type = int32_t;
+		using value_type = Point;
+
+	private:
+		constexpr static uint32_t Skip = 4;
+		constexpr static uint32_t End = 9;
+		Point m_Center;
+		Size m_Size;
+		uint32_t m_Index;
+	};
+
+	constexpr AroundPointView(const Point& center, const Size& size) : m_Center(center), m_Size(size) {}
+	constexpr Iterator begin() const { return Iterator(m_Center, m_Size); }
+	constexpr Sentinel end() const { return {}; }
+
+private:
+	Point m_Center;
+	Size m_Size;
+};
+
+template <>
+inline constexpr bool std::ranges::enable_borrowed_range<AroundPointView> = true;
@@ -0,0 +1,87 @@
+﻿#include <system_error>
+#include "MappedFile.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::filesystem::path& path) : m_Data(nullptr), m_Size(0), m_File(INVALID_HANDLE_VALUE), m_Mapping(nullptr)
+{
+	m_File = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	LARGE_INTEGER size{};
+	if (m_File == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_File, &size))
+	{
+		const auto error = GetLastError();
+		Close();
+		throw std::system_error(static_cast<int>(error), std::system_category(), "The file could not be opened.");
+	}
+	m_Size = static_cast<size_t>(size.QuadPart);
+	if (m_Size == 0)
+		return;
+	m_Mapping = CreateFileMappingW(m_File, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	if (m_Mapping)
+		m_Data = static_cast<std::byte*>(MapViewOfFile(m_Mapping, FILE_MAP_COPY, 0, 0, 0));
+	if (!m_Data)
+	{
+		const auto error = GetLastError();
+		Close();
+		throw std::system_error(static_cast<int>(error), std::system_category(), "The file could not be mapped.");
+	}
+}
+
+void MappedFile::Close()
+{
+	if (m_Data)
+		UnmapViewOfFile(m_Data);
+	if (m_Mapping)
+		CloseHandle(m_Mapping);
+	if (m_File != INVALID_HANDLE_VALUE)
+		CloseHandle(m_File);
+	m_Data = nullptr;
+	m_Mapping = nullptr;
+	m_File = INVALID_HANDLE_VALUE;
+}
+#else
+MappedFile::MappedFile(const std::filesystem::path& path) : m_Data(nullptr), m_Size(0)
+{
+	const auto file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	struct stat status{};
+	if (file < 0 || fstat(file, &status) != 0)
+	{
+		const auto error = errno;
+		if (file >= 0)
+			close(file);
+		throw std::system_error(error, std::generic_category(), "The file could not be opened.");
+	}
+	m_Size = static_cast<size_t>(status.st_size);
+	if (m_Size > 0)
+	{
+		// ファイルを閉じても写像は残る
+		const auto data = mmap(nullptr, m_Size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+		const auto error = errno;
+		close(file);
+		if (data == MAP_FAILED)
+			throw std::system_error(error, std::generic_category(), "The file could not be mapped.");
+		m_Data = static_cast<std::byte*>(data);
+	}
+	else
+		close(file);
+}
+
+void MappedFile::Close()
+{
+	if (m_Data)
+		munmap(m_Data, m_Size);
+	m_Data = nullptr;
+}
+#endif
@@ -0,0 +1,29 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+// ファイル全体を読み書き可能なコピーオンライトでメモリに写像する（書き換えてもファイルには反映されない）
+class MappedFile
+{
+public:
+	// 開けなければ std::system_error を送出する
+	explicit MappedFile(const std::filesystem::path& path);
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator =(const MappedFile&) = delete;
+	~MappedFile();
+
+	std::span<std::byte> GetData() const { return std::span<std::byte>(m_Data, m_Size); }
+
+private:
+	void Close();
+
+	std::byte* m_Data;
+	size_t m_Size;
+#ifdef _WIN32
+	void* m_File;
+	void* m_Mapping;
+#endif
+};
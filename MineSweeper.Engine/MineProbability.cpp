@@ -0,0 +1,433 @@
+﻿#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include "MineProbability.h"
+
+namespace
+{
+	constexpr uint32_t NoIndex = std::numeric_limits<uint32_t>::max();
+	// 近似で制約ごとの比率合わせを繰り返す回数
+	constexpr uint32_t ApproximationPasses = 32;
+	// 経過時間を確認する探索ノードの間隔
+	constexpr uint32_t DeadlineCheckInterval = 4096;
+
+	struct Constraint
+	{
+		std::vector<uint32_t> Cells;
+		uint32_t Mines;
+	};
+
+	// 互いに制約を共有する境界セルの集まり
+	struct Component
+	{
+		std::vector<size_t> Cells;
+		std::vector<Constraint> Constraints;
+		// Weights[k]: 成分内の地雷が k 個になる配置の重み、MineWeights[i * (n + 1) + k]: そのうちセル i に地雷がある配置の重み
+		std::vector<double> Weights;
+		std::vector<double> MineWeights;
+		bool IsExact = true;
+
+		size_t CountCells() const { return Cells.size(); }
+		double& MineWeightAt(size_t cell, size_t mines) { return MineWeights[cell * (Cells.size() + 1) + mines]; }
+		double MineWeightAt(size_t cell, size_t mines) const { return MineWeights[cell * (Cells.size() + 1) + mines]; }
+	};
+
+	class Enumerator
+	{
+	public:
+		Enumerator(Component& component, uint32_t maxMines, std::chrono::steady_clock::time_point deadline) :
+			m_Component(component),
+			m_MaxMines(maxMines),
+			m_Deadline(deadline),
+			m_CellConstraints(component.CountCells()),
+			m_Assigned(component.Constraints.size()),
+			m_Remaining(component.Constraints.size()),
+			m_Assignment(component.CountCells()),
+			m_Nodes(0)
+		{
+			for (uint32_t i = 0; i < component.Constraints.size(); i++)
+			{
+				m_Remaining[i] = static_cast<uint32_t>(component.Constraints[i].Cells.size());
+				for (auto cell : component.Constraints[i].Cells)
+					m_CellConstraints[cell].emplace_back(i);
+			}
+		}
+
+		// 時間内に数え上げを終えれば true
+		bool Run() { return Visit(0, 0); }
+
+	private:
+		Component& m_Component;
+		uint32_t m_MaxMines;
+		std::chrono::steady_clock::time_point m_Deadline;
+		std::vector<std::vector<uint32_t>> m_CellConstraints;
+		std::vector<uint32_t> m_Assigned;
+		std::vector<uint32_t> m_Remaining;
+		std::vector<bool> m_Assignment;
+		uint32_t m_Nodes;
+
+		bool Visit(uint32_t cell, uint32_t mines)
+		{
+			if (++m_Nodes % DeadlineCheckInterval == 0 && std::chrono::steady_clock::now() > m_Deadline)
+				return false;
+			if (cell == m_Component.CountCells())
+			{
+				m_Component.Weights[mines] += 1;
+				for (uint32_t i = 0; i < m_Assignment.size(); i++)
+				{
+					if (m_Assignment[i])
+						m_Component.MineWeightAt(i, mines) += 1;
+				}
+				return true;
+			}
+			for (uint32_t value = 0; value <= 1; value++)
+			{
+				if (value == 1 && mines == m_MaxMines)
+					break;
+				m_Assignment[cell] = value == 1;
+				bool consistent = true;
+				for (auto index : m_CellConstraints[cell])
+				{
+					m_Assigned[index] += value;
+					m_Remaining[index]--;
+					const auto needed = m_Component.Constraints[index].Mines;
+					consistent = consistent && m_Assigned[index] <= needed && m_Assigned[index] + m_Remaining[index] >= needed;
+				}
+				const bool completed = !consistent || Visit(cell + 1, mines + value);
+				for (auto index : m_CellConstraints[cell])
+				{
+					m_Assigned[index] -= value;
+					m_Remaining[index]++;
+				}
+				if (!completed)
+					return false;
+			}
+			m_Assignment[cell] = false;
+			return true;
+		}
+	};
+
+	// 制約ごとに、その制約のセルの確率の和が地雷数に一致するよう比率を合わせることを繰り返す
+	void Approximate(Component& component, double density)
+	{
+		const auto n = component.CountCells();
+		std::vector<double> probabilities(n, density);
+		for (uint32_t pass = 0; pass < ApproximationPasses; pass++)
+		{
+			for (const auto& constraint : component.Constraints)
+			{
+				double sum = 0;
+				for (auto cell : constraint.Cells)
+					sum += probabilities[cell];
+				if (sum <= 0)
+					continue;
+				const auto ratio = constraint.Mines / sum;
+				for (auto cell : constraint.Cells)
+					probabilities[cell] = std::clamp(probabilities[cell] * ratio, 0.0, 1.0);
+			}
+		}
+		// 地雷数の分布は期待値の 1 点に集中しているものとして扱う
+		const auto expected = std::min(static_cast<size_t>(std::lround(std::accumulate(probabilities.begin(), probabilities.end(), 0.0))), n);
+		component.Weights.assign(n + 1, 0);
+		component.MineWeights.assign(n * (n + 1), 0);
+		component.Weights[expected] = 1;
+		for (size_t i = 0; i < n; i++)
+			component.MineWeightAt(i, expected) = probabilities[i];
+		component.IsExact = false;
+	}
+
+	void Solve(Component& component, const ProbabilityOptions& options, uint32_t maxMines, double density, std::chrono::steady_clock::time_point deadline)
+	{
+		const auto n = component.CountCells();
+		if (n <= options.MaxExactCells)
+		{
+			component.Weights.assign(n + 1, 0);
+			component.MineWeights.assign(n * (n + 1), 0);
+			const auto total = Enumerator(component, std::min<uint32_t>(maxMines, static_cast<uint32_t>(n)), deadline).Run() ?
+				std::accumulate(component.Weights.begin(), component.Weights.end(), 0.0) :
+				0.0;
+			if (total > 0)
+			{
+				// 配置の数は成分の数だけ掛け合わされるので、成分ごとに正規化してあふれを防ぐ
+				for (auto& weight : component.Weights)
+					weight /= total;
+				for (auto& weight : component.MineWeights)
+					weight /= total;
+				return;
+			}
+		}
+		Approximate(component, density);
+	}
+
+	// 境界セルを共有する制約どうしでまとめ、連結成分に分ける
+	std::vector<Component> SplitComponents(const Game& game, std::vector<uint32_t>& frontier)
+	{
+		const auto& size = game.GetSize();
+		std::vector<Constraint> constraints;
+		std::vector<size_t> frontierCells;
+		for (const auto& loc : AllPointView(size))
+		{
+			const auto& cell = game.GetCell(loc);
+			if (cell.State != CellState::Open || cell.AroundMines == 0)
+				continue;
+			Constraint constraint { {}, cell.AroundMines };
+			for (auto pos : AroundPointView(loc, size))
+			{
+				const auto state = game.GetCell(pos).State;
+				const auto index = static_cast<size_t>(pos.Y) * size.Width + pos.X;
+				if (state == CellState::Flagged)
+					constraint.Mines--;
+				else if (state == CellState::Closed)
+				{
+					if (frontier[index] == NoIndex)
+					{
+						frontier[index] = static_cast<uint32_t>(frontierCells.size());
+						frontierCells.emplace_back(index);
+					}
+					constraint.Cells.emplace_back(frontier[index]);
+				}
+			}
+			if (!constraint.Cells.empty())
+				constraints.emplace_back(std::move(constraint));
+		}
+
+		std::vector<uint32_t> parents(frontierCells.size());
+		std::iota(parents.begin(), parents.end(), 0);
+		const auto find = [&](uint32_t value)
+		{
+			while (parents[value] != value)
+				value = parents[value] = parents[parents[value]];
+			return value;
+		};
+		for (const auto& constraint : constraints)
+		{
+			for (auto cell : constraint.Cells)
+				parents[find(cell)] = find(constraint.Cells.front());
+		}
+
+		// 境界セルの番号を成分内の番号に付け替える（制約は行順に現れるため、近いセルが近い番号になる）
+		std::vector<Component> components;
+		std::vector<uint32_t> componentOf(frontierCells.size(), NoIndex);
+		std::vector<uint32_t> local(frontierCells.size());
+		for (uint32_t i = 0; i < frontierCells.size(); i++)
+		{
+			auto& id = componentOf[find(i)];
+			if (id == NoIndex)
+			{
+				id = static_cast<uint32_t>(components.size());
+				components.emplace_back();
+			}
+			local[i] = static_cast<uint32_t>(components[id].Cells.size());
+			components[id].Cells.emplace_back(frontierCells[i]);
+		}
+		for (auto& constraint : constraints)
+		{
+			auto& component = components[componentOf[find(constraint.Cells.front())]];
+			for (auto& cell : constraint.Cells)
+				cell = local[cell];
+			component.Constraints.emplace_back(std::move(constraint));
+		}
+		return components;
+	}
+
+	double LogCombination(size_t n, size_t k) { return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0); }
+
+	// 各成分の地雷数の合計が K のとき、残りの地雷を内側のセルに置く組み合わせの数 C(interior, remaining - K) を重みとして合成する
+	// 矛盾のない配置が 1 つもなければ std::nullopt を返す
+	std::optional<double> CombineExactly(std::vector<Component>& components, std::vector<double>& values, size_t remaining, size_t interior)
+	{
+		const auto frontier = std::accumulate(components.begin(), components.end(), size_t(0), [](size_t sum, const Component& component) { return sum + component.CountCells(); });
+		const auto limit = std::min(frontier, remaining);
+		std::vector<double> logWeights(limit + 1, -std::numeric_limits<double>::infinity());
+		for (size_t k = 0; k <= limit; k++)
+		{
+			if (remaining - k <= interior)
+				logWeights[k] = LogCombination(interior, remaining - k);
+		}
+		const auto maxLogWeight = *std::max_element(logWeights.begin(), logWeights.end());
+		std::vector<double> weights(limit + 1);
+		for (size_t k = 0; k <= limit; k++)
+			weights[k] = std::exp(logWeights[k] - maxLogWeight);
+
+		// suffixes[c][j]: 成分 0..c-1 の地雷数の合計が j のとき、成分 c 以降の配置と内側の重みを掛けた和
+		const auto count = components.size();
+		std::vector<size_t> prefixCells(count + 1, 0);
+		for (size_t c = 0; c < count; c++)
+			prefixCells[c + 1] = prefixCells[c] + components[c].CountCells();
+		std::vector<std::vector<double>> suffixes(count + 1);
+		suffixes[count].assign(weights.begin(), weights.begin() + std::min(prefixCells[count], limit) + 1);
+		for (size_t c = count; c-- > 0;)
+		{
+			auto& suffix = suffixes[c];
+			suffix.assign(std::min(prefixCells[c], limit) + 1, 0);
+			const auto& next = suffixes[c + 1];
+			for (size_t j = 0; j < suffix.size(); j++)
+			{
+				for (size_t k = 0; k < components[c].Weights.size() && j + k < next.size(); k++)
+					suffix[j] += components[c].Weights[k] * next[j + k];
+			}
+		}
+		const auto total = suffixes[0][0];
+		if (!(total > 0))
+			return std::nullopt;
+
+		// prefix[j]: 成分 0..c-1 の地雷数の合計が j になる配置の重み
+		std::vector<double> prefix { 1.0 };
+		for (size_t c = 0; c < count; c++)
+		{
+			const auto& component = components[c];
+			const auto& next = suffixes[c + 1];
+			std::vector<double> others(component.Weights.size(), 0);
+			for (size_t k = 0; k < others.size(); k++)
+			{
+				for (size_t j = 0; j < prefix.size() && j + k < next.size(); j++)
+					others[k] += prefix[j] * next[j + k];
+			}
+			for (size_t i = 0; i < component.CountCells(); i++)
+			{
+				double sum = 0;
+				for (size_t k = 0; k < others.size(); k++)
+					sum += component.MineWeightAt(i, k) * others[k];
+				values[component.Cells[i]] = sum / total;
+			}
+			std::vector<double> nextPrefix(std::min(prefixCells[c + 1], limit) + 1, 0);
+			for (size_t j = 0; j < prefix.size(); j++)
+			{
+				for (size_t k = 0; k < component.Weights.size() && j + k < nextPrefix.size(); k++)
+					nextPrefix[j + k] += prefix[j] * component.Weights[k];
+			}
+			prefix = std::move(nextPrefix);
+		}
+		if (interior == 0)
+			return 0;
+		// 内側のセルの確率は、内側に置かれる地雷数の期待値を内側のセル数で割ったもの
+		double expected = 0;
+		for (size_t k = 0; k < prefix.size(); k++)
+			expected += prefix[k] * weights[k] * static_cast<double>(remaining - k);
+		return expected / total / static_cast<double>(interior);
+	}
+
+	// 境界が大きいときは、内側の地雷の密度が一定とみなして成分 1 つあたりの地雷数に odds^k の重みを付け、成分を独立に扱う
+	double CombineIndependently(std::vector<Component>& components, std::vector<double>& values, size_t remaining, size_t interior)
+	{
+		const auto frontier = std::accumulate(components.begin(), components.end(), size_t(0), [](size_t sum, const Component& component) { return sum + component.CountCells(); });
+		double density = static_cast<double>(remaining) / static_cast<double>(frontier + interior);
+		for (uint32_t pass = 0; pass < ApproximationPasses; pass++)
+		{
+			const auto odds = interior == 0 ? 1.0 : density / (1 - density);
+			double expected = 0;
+			for (auto& component : components)
+			{
+				double total = 0;
+				double mines = 0;
+				double power = 1;
+				for (size_t k = 0; k < component.Weights.size(); k++, power *= odds)
+				{
+					total += component.Weights[k] * power;
+					mines += component.Weights[k] * power * static_cast<double>(k);
+				}
+				if (total > 0)
+					expected += mines / total;
+			}
+			if (interior == 0)
+				break;
+			density = std::clamp((static_cast<double>(remaining) - expected) / static_cast<double>(interior), 1e-9, 1 - 1e-9);
+		}
+		const auto odds = interior == 0 ? 1.0 : density / (1 - density);
+		for (auto& component : components)
+		{
+			double total = 0;
+			double power = 1;
+			for (size_t k = 0; k < component.Weights.size(); k++, power *= odds)
+				total += component.Weights[k] * power;
+			for (size_t i = 0; i < component.CountCells(); i++)
+			{
+				double sum = 0;
+				power = 1;
+				for (size_t k = 0; k < component.Weights.size(); k++, power *= odds)
+					sum += component.MineWeightAt(i, k) * power;
+				values[component.Cells[i]] = total > 0 ? sum / total : density;
+			}
+		}
+		return interior == 0 ? 0 : density;
+	}
+}
+
+std::optional<Point> MineProbabilities::FindSafestCell(const Game& game) const
+{
+	std::optional<Point> result;
+	double best = std::numeric_limits<double>::infinity();
+	for (const auto& loc : AllPointView(m_Size))
+	{
+		if (game.GetCell(loc).State == CellState::Closed && GetProbability(loc) < best)
+		{
+			best = GetProbability(loc);
+			result = loc;
+		}
+	}
+	return result;
+}
+
+MineProbabilities CalculateMineProbabilities(const Game& game, const ProbabilityOptions& options)
+{
+	const auto deadline = std::chrono::steady_clock::now() + options.TimeLimit;
+	const auto& size = game.GetSize();
+	const auto cells = game.GetCells();
+	std::vector<uint32_t> frontier(cells.size(), NoIndex);
+	auto components = SplitComponents(game, frontier);
+
+	size_t closed = 0;
+	for (const auto& cell : cells)
+	{
+		if (cell.State == CellState::Closed)
+			closed++;
+	}
+	const auto remaining = static_cast<size_t>(std::max(game.CountUnflaggedMines(), 0));
+	const auto density = closed == 0 ? 0.0 : static_cast<double>(remaining) / static_cast<double>(closed);
+
+	// 連結成分は互いに独立なので、空いたスレッドが次の成分を取って解く
+	const auto maxMines = static_cast<uint32_t>(std::min<size_t>(remaining, std::numeric_limits<uint32_t>::max()));
+	const auto threadCount = std::min<size_t>(options.Threads > 0 ? options.Threads : std::max(std::thread::hardware_concurrency(), 1u), components.size());
+	std::atomic<size_t> next = 0;
+	const auto work = [&]()
+	{
+		for (size_t i = next++; i < components.size(); i = next++)
+			Solve(components[i], options, maxMines, density, deadline);
+	};
+	if (threadCount > 1)
+	{
+		std::vector<std::jthread> threads;
+		for (size_t i = 1; i < threadCount; i++)
+			threads.emplace_back(work);
+		work();
+	}
+	else
+		work();
+
+	std::vector<double> values(cells.size(), 0);
+	size_t frontierCells = 0;
+	bool isExact = true;
+	for (const auto& component : components)
+	{
+		frontierCells += component.CountCells();
+		isExact = isExact && component.IsExact;
+	}
+	const auto interior = closed - frontierCells;
+	auto interiorProbability = frontierCells <= options.MaxExactFrontier ? CombineExactly(components, values, remaining, interior) : std::nullopt;
+	if (!interiorProbability)
+	{
+		interiorProbability = CombineIndependently(components, values, remaining, interior);
+		isExact = false;
+	}
+	for (size_t i = 0; i < cells.size(); i++)
+	{
+		if (cells[i].State == CellState::Flagged)
+			values[i] = 1;
+		else if (cells[i].State == CellState::Closed && frontier[i] == NoIndex)
+			values[i] = *interiorProbability;
+	}
+	return MineProbabilities(size, std::move(values), isExact);
+}
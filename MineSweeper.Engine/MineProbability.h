@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "Game.h"
+
+struct ProbabilityOptions
+{
+	constexpr ProbabilityOptions() : Threads(0), MaxExactCells(48), MaxExactFrontier(2048), TimeLimit(1000) { }
+
+	// 連結成分を並列に解くスレッド数（0 のときはハードウェアのスレッド数）
+	uint32_t Threads;
+	// 1 つの連結成分で配置を厳密に数え上げるセル数の上限
+	uint32_t MaxExactCells;
+	// 残り地雷数による重み付けを厳密に行う境界セルの総数の上限
+	uint32_t MaxExactFrontier;
+	// 数え上げ全体にかける時間の上限（超えた成分は近似に切り替える）
+	std::chrono::milliseconds TimeLimit;
+};
+
+// セルごとに地雷がある確率（開いているセルは 0、旗のあるセルは 1）
+class MineProbabilities
+{
+public:
+	MineProbabilities(const Size& size, std::vector<double> values, bool isExact) : m_Size(size), m_Values(std::move(values)), m_IsExact(isExact) { }
+
+	constexpr const Size& GetSize() const { return m_Size; }
+	double GetProbability(const Point& loc) const { return m_Values[static_cast<size_t>(loc.Y) * m_Size.Width + loc.X]; }
+	// 近似に切り替えた成分がなければ true
+	constexpr bool IsExact() const { return m_IsExact; }
+	// 閉じているセルのうち地雷がある確率が最も低いセルを返す
+	std::optional<Point> FindSafestCell(const Game& game) const;
+
+private:
+	Size m_Size;
+	std::vector<double> m_Values;
+	bool m_IsExact;
+};
+
+// 開いているセルの数字と旗から、閉じているセルに地雷がある確率を求める（旗はすべて正しい位置にあることを前提とする）
+// 数字に接する閉じたセルを互いに独立な連結成分に分けて成分ごとに地雷の配置を数え上げ、残り地雷数で重み付けして合成する
+MineProbabilities CalculateMineProbabilities(const Game& game, const ProbabilityOptions& options = ProbabilityOptions());
@@ -0,0 +1,52 @@
+﻿#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "NoGuessGenerator.h"
+#include "Solver.h"
+
+bool PlaceMinesWithoutGuessing(Game& game, const Point& first, const NoGuessOptions& options)
+{
+	if (game.HasPlacedMines())
+		return false;
+	const auto deadline = std::chrono::steady_clock::now() + options.TimeLimit;
+	const auto threadCount = options.Threads > 0 ? options.Threads : std::max(std::thread::hardware_concurrency(), 1u);
+
+	std::atomic<bool> found = false;
+	uint64_t foundSeed = 0;
+	const auto seed = Random::GenerateSeed();
+	const auto work = [&](uint32_t index)
+	{
+		Random random(seed + index);
+		Game candidate(game.GetSize(), game.GetMines(), seed);
+		Solver solver(candidate);
+		while (!found && std::chrono::steady_clock::now() < deadline)
+		{
+			candidate.Reset(random.Next());
+			candidate.PlaceMines(first);
+			solver.Reset();
+			solver.Open(first);
+			solver.Solve();
+			// 最初に解けたスレッドだけがシードを書き出す
+			if (candidate.GetProgress() == GameProgress::Completed && !found.exchange(true))
+				foundSeed = candidate.GetSeed();
+		}
+	};
+	{
+		std::vector<std::jthread> threads;
+		// 破棄した候補の盤面を終了するスレッドに残さない（呼び出し元のスレッドの分は次の呼び出しで再利用する）
+		for (uint32_t i = 1; i < threadCount; i++)
+			threads.emplace_back([&work](uint32_t index)
+				{
+					work(index);
+					Game::ClearBufferPool();
+				}, i);
+		work(0);
+	}
+	if (!found)
+		return false;
+	// 見つかった配置のシードでゲームを始め直すので、そのシードからいつでも同じ盤面を再現できる
+	game.Reset(foundSeed);
+	game.PlaceMines(first);
+	return true;
+}
@@ -0,0 +1,20 @@
+﻿#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include "Game.h"
+
+struct NoGuessOptions
+{
+	constexpr NoGuessOptions() : Threads(0), TimeLimit(500) { }
+
+	// 候補の盤面を並列に試すスレッド数（0 のときはハードウェアのスレッド数）
+	uint32_t Threads;
+	// この時間内に推測なしで解ける配置が見つからなければあきらめる
+	std::chrono::milliseconds TimeLimit;
+};
+
+// first を最初に開いたときに推測なしで解ける配置を探して game に地雷を置く
+// 各スレッドが候補のシードで配置を作っては Solver で最後まで解けるかを確かめ、最初に解けたシードで game を始め直す（それまでの旗は消える）
+// 時間内に見つからなければ地雷を置かずに false を返す（その場合は通常どおり OpenCell で置かれる）
+bool PlaceMinesWithoutGuessing(Game& game, const Point& first, const NoGuessOptions& options = NoGuessOptions());
@@ -0,0 +1,89 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <random>
+
+// xoshiro256** による乱数生成器（状態は 32 バイトで、シードから SplitMix64 で状態を作る）
+// 同じシードからはどの環境でも同じ系列を返すよう、範囲内の整数も標準の分布を使わずに自前で求める
+class Random
+{
+public:
+	using result_type = uint64_t;
+
+	constexpr explicit Random(uint64_t seed) : m_State()
+	{
+		for (auto& state : m_State)
+			state = SplitMix64(seed);
+	}
+
+	// std::random_device から新しいシードを作る
+	static uint64_t GenerateSeed()
+	{
+		std::random_device device;
+		return static_cast<uint64_t>(device()) << 32 | device();
+	}
+
+	// SplitMix64 で seed から作る系列の index 番目を返す（並列に処理する各ゲームのシードを、処理の順序によらず番号だけから決める）
+	constexpr static uint64_t DeriveSeed(uint64_t seed, uint64_t index)
+	{
+		auto state = seed + index * 0x9E3779B97F4A7C15;
+		return SplitMix64(state);
+	}
+
+	constexpr static result_type min() { return std::numeric_limits<result_type>::min(); }
+	constexpr static result_type max() { return std::numeric_limits<result_type>::max(); }
+	constexpr result_type operator ()() { return Next(); }
+
+	constexpr uint64_t Next()
+	{
+		const auto result = RotateLeft(m_State[1] * 5, 7) * 9;
+		const auto t = m_State[1] << 17;
+		m_State[2] ^= m_State[0];
+		m_State[3] ^= m_State[1];
+		m_State[1] ^= m_State[2];
+		m_State[0] ^= m_State[3];
+		m_State[2] ^= t;
+		m_State[3] = RotateLeft(m_State[3], 45);
+		return result;
+	}
+	// [0, bound) の一様な整数を返す（Lemire の乗算による方法で、偏りの出る範囲のみ引き直す）
+	constexpr uint64_t NextBelow(uint64_t bound)
+	{
+		uint64_t low = 0;
+		auto high = MultiplyWide(Next(), bound, low);
+		if (low < bound)
+		{
+			const auto threshold = (0 - bound) % bound;
+			while (low < threshold)
+				high = MultiplyWide(Next(), bound, low);
+		}
+		return high;
+	}
+
+private:
+	uint64_t m_State[4];
+
+	constexpr static uint64_t RotateLeft(uint64_t value, int shift) { return value << shift | value >> (64 - shift); }
+	constexpr static uint64_t SplitMix64(uint64_t& state)
+	{
+		auto z = state += 0x9E3779B97F4A7C15;
+		z = (z ^ z >> 30) * 0xBF58476D1CE4E5B9;
+		z = (z ^ z >> 27) * 0x94D049BB133111EB;
+		return z ^ z >> 31;
+	}
+	// 64 ビット同士の積の上位 64 ビットを返し、下位 64 ビットを low に格納する
+	constexpr static uint64_t MultiplyWide(uint64_t left, uint64_t right, uint64_t& low)
+	{
+		const auto leftLow = left & 0xFFFFFFFF;
+		const auto leftHigh = left >> 32;
+		const auto rightLow = right & 0xFFFFFFFF;
+		const auto rightHigh = right >> 32;
+		const auto lowLow = leftLow * rightLow;
+		const auto highLow = leftHigh * rightLow;
+		const auto lowHigh = leftLow * rightHigh;
+		const auto middle = (lowLow >> 32) + (highLow & 0xFFFFFFFF) + (lowHigh & 0xFFFFFFFF);
+		low = (middle << 32) | (lowLow & 0xFFFFFFFF);
+		return leftHigh * rightHigh + (highLow >> 32) + (lowHigh >> 32) + (middle >> 32);
+	}
+};
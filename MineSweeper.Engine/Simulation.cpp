@@ -0,0 +1,174 @@
+﻿#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Game.h"
+#include "MineProbability.h"
+#include "Simulation.h"
+#include "Solver.h"
+
+namespace
+{
+	// 1 度に自分の範囲から取り出すゲームの数
+	constexpr uint64_t ChunkSize = 64;
+
+	// 1 つのスレッドが受け持つゲーム番号の範囲 [Begin, End)
+	struct alignas(64) WorkRange
+	{
+		std::mutex Mutex;
+		uint64_t Begin = 0;
+		uint64_t End = 0;
+	};
+
+	class Worker
+	{
+	public:
+		Worker(const SimulationOptions& options, uint64_t seed) :
+			m_Game(options.Size, options.Mines, seed),
+			m_Solver(m_Game),
+			m_Seed(seed),
+			m_First(options.Size.Width / 2, options.Size.Height / 2)
+		{
+			m_ProbabilityOptions.Threads = 1;
+		}
+
+		// 盤面とソルバーは作り直さずに再利用し、ゲームの番号から決まるシードで始め直す
+		void Play(uint64_t index, SimulationResult& result)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			m_Game.Reset(Random::DeriveSeed(m_Seed, index));
+			m_Game.PlaceMines(m_First);
+			m_Solver.Reset();
+			m_Solver.Open(m_First);
+			uint64_t guesses = 0;
+			while (true)
+			{
+				m_Solver.Solve();
+				if (m_Game.GetProgress() != GameProgress::InProgress)
+					break;
+				const auto probabilities = CalculateMineProbabilities(m_Game, m_ProbabilityOptions);
+				const auto safest = probabilities.FindSafestCell(m_Game);
+				if (!safest)
+					break;
+				if (probabilities.GetProbability(*safest) > 0)
+					guesses++;
+				m_Solver.Open(*safest);
+			}
+			result.Games++;
+			if (m_Game.GetProgress() == GameProgress::Completed)
+				result.Wins++;
+			result.Clicks += m_Solver.GetStatistics().OpenActions + m_Solver.GetStatistics().FlagActions;
+			result.Guesses += guesses;
+			if (guesses > 0)
+				result.GuessedGames++;
+			result.GameTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+		}
+
+	private:
+		Game m_Game;
+		Solver m_Solver;
+		uint64_t m_Seed;
+		Point m_First;
+		ProbabilityOptions m_ProbabilityOptions;
+	};
+
+	// 自分の範囲から取り出せなければ、残りの最も多いスレッドから後ろ半分を奪う
+	bool TakeChunk(std::vector<WorkRange>& ranges, size_t self, uint64_t& begin, uint64_t& end)
+	{
+		{
+			std::lock_guard lock(ranges[self].Mutex);
+			if (ranges[self].Begin < ranges[self].End)
+			{
+				begin = ranges[self].Begin;
+				end = std::min(begin + ChunkSize, ranges[self].End);
+				ranges[self].Begin = end;
+				return true;
+			}
+		}
+		while (true)
+		{
+			size_t victim = self;
+			uint64_t most = 0;
+			for (size_t i = 0; i < ranges.size(); i++)
+			{
+				std::lock_guard lock(ranges[i].Mutex);
+				if (i != self && ranges[i].End - ranges[i].Begin > most)
+				{
+					most = ranges[i].End - ranges[i].Begin;
+					victim = i;
+				}
+			}
+			if (victim == self)
+				return false;
+			std::scoped_lock lock(ranges[self].Mutex, ranges[victim].Mutex);
+			auto& stolen = ranges[victim];
+			if (stolen.Begin >= stolen.End)
+				continue;
+			const auto middle = stolen.Begin + (stolen.End - stolen.Begin) / 2;
+			ranges[self].Begin = middle;
+			ranges[self].End = stolen.End;
+			stolen.End = middle;
+			begin = ranges[self].Begin;
+			end = std::min(begin + ChunkSize, ranges[self].End);
+			ranges[self].Begin = end;
+			return true;
+		}
+	}
+}
+
+SimulationResult& SimulationResult::operator +=(const SimulationResult& right)
+{
+	Games += right.Games;
+	Wins += right.Wins;
+	Clicks += right.Clicks;
+	Guesses += right.Guesses;
+	GuessedGames += right.GuessedGames;
+	GameTime += right.GameTime;
+	return *this;
+}
+
+SimulationResult RunSimulation(const SimulationOptions& options)
+{
+	const auto start = std::chrono::steady_clock::now();
+	const auto threadCount = static_cast<size_t>(std::clamp<uint64_t>(options.Threads > 0 ? options.Threads : std::max(std::thread::hardware_concurrency(), 1u), 1, std::max<uint64_t>(options.Games, 1)));
+	const auto seed = options.Seed ? *options.Seed : Random::GenerateSeed();
+
+	std::vector<WorkRange> ranges(threadCount);
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		ranges[i].Begin = options.Games * i / threadCount;
+		ranges[i].End = options.Games * (i + 1) / threadCount;
+	}
+	std::vector<SimulationResult> results(threadCount);
+	const auto work = [&](size_t index)
+	{
+		Worker worker(options, seed);
+		SimulationResult result;
+		uint64_t begin = 0;
+		uint64_t end = 0;
+		while (TakeChunk(ranges, index, begin, end))
+		{
+			for (auto i = begin; i < end; i++)
+				worker.Play(i, result);
+		}
+		results[index] = result;
+	};
+	{
+		std::vector<std::jthread> threads;
+		// 破棄した盤面を終了するスレッドに残さない（呼び出し元のスレッドの分は次の呼び出しで再利用する）
+		for (size_t i = 1; i < threadCount; i++)
+			threads.emplace_back([&work](size_t index)
+				{
+					work(index);
+					Game::ClearBufferPool();
+				}, i);
+		work(0);
+	}
+
+	SimulationResult total;
+	for (const auto& result : results)
+		total += result;
+	total.Elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+	return total;
+}
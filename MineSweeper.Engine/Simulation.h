@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include "Geometry.h"
+
+struct SimulationOptions
+{
+	constexpr SimulationOptions() : Size(30, 16), Mines(99), Games(10000), Threads(0), Seed() { }
+
+	::Size Size;
+	uint32_t Mines;
+	uint64_t Games;
+	// 0 のときはハードウェアのスレッド数
+	uint32_t Threads;
+	// 指定しなければ std::random_device から作る（各ゲームのシードは Seed とゲームの番号から作るので、スレッド数によらず同じ結果になる）
+	std::optional<uint64_t> Seed;
+};
+
+struct SimulationResult
+{
+	constexpr SimulationResult() : Games(0), Wins(0), Clicks(0), Guesses(0), GuessedGames(0), GameTime(0), Elapsed(0) { }
+
+	uint64_t Games;
+	uint64_t Wins;
+	// 開く操作と旗を立てる操作の合計（最初のクリックを含む）
+	uint64_t Clicks;
+	// 確率が 0 でないセルを開いた回数
+	uint64_t Guesses;
+	uint64_t GuessedGames;
+	// 各ゲームの所要時間の合計
+	std::chrono::nanoseconds GameTime;
+	std::chrono::nanoseconds Elapsed;
+
+	SimulationResult& operator +=(const SimulationResult& right);
+};
+
+// 盤面の中央を最初に開き、推論で進めなくなったら地雷の確率が最も低いセルを開く自動プレイヤーで多数のゲームを行う
+// ゲームの番号の範囲をスレッドごとに分け、自分の範囲を使い切ったスレッドは他のスレッドの残りの半分を奪って続ける
+SimulationResult RunSimulation(const SimulationOptions& options);
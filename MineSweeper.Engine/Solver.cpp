@@ -0,0 +1,209 @@
+﻿#include <algorithm>
+#include "Solver.h"
+
+Solver::Solver(Game& game) :
+	m_Game(game),
+	m_Known(game.GetCells().size()),
+	m_IsPending(game.GetCells().size())
+{
+	Reset();
+}
+
+void Solver::Reset()
+{
+	std::fill(m_Known.begin(), m_Known.end(), false);
+	std::fill(m_IsPending.begin(), m_IsPending.end(), false);
+	m_Pending.clear();
+	m_Statistics = SolverStatistics();
+	for (const auto& loc : AllPointView(m_Game.GetSize()))
+	{
+		if (m_Game.GetCell(loc).State == CellState::Open)
+		{
+			m_Known[IndexOf(loc)] = true;
+			Enqueue(loc);
+		}
+	}
+}
+
+size_t Solver::Open(const Point& loc)
+{
+	const auto opened = m_Game.OpenCell(loc);
+	if (opened > 0)
+	{
+		m_Statistics.OpenActions++;
+		m_Statistics.OpenedCells += opened;
+		Discover(loc);
+	}
+	return opened;
+}
+
+size_t Solver::Solve()
+{
+	size_t actions = 0;
+	while (!m_Pending.empty() && m_Game.GetProgress() == GameProgress::InProgress)
+	{
+		const auto loc = m_Pending.back();
+		m_Pending.pop_back();
+		m_IsPending[IndexOf(loc)] = false;
+		if (Examine(loc))
+			actions++;
+	}
+	return actions;
+}
+
+void Solver::Enqueue(const Point& loc)
+{
+	const auto& cell = m_Game.GetCell(loc);
+	if (cell.State != CellState::Open || cell.AroundMines == 0 || m_IsPending[IndexOf(loc)])
+		return;
+	m_IsPending[IndexOf(loc)] = true;
+	m_Pending.emplace_back(loc);
+}
+
+void Solver::EnqueueAround(const Point& loc)
+{
+	for (auto pos : AroundPointView(loc, m_Game.GetSize()))
+		Enqueue(pos);
+}
+
+void Solver::Discover(const Point& loc)
+{
+	// 開いたセルから、まだ把握していない開いたセルをたどる（連鎖して開いた範囲だけを走査する）
+	m_Discovering.clear();
+	m_Discovering.emplace_back(loc);
+	while (!m_Discovering.empty())
+	{
+		const auto current = m_Discovering.back();
+		m_Discovering.pop_back();
+		const auto& cell = m_Game.GetCell(current);
+		if (cell.State != CellState::Open)
+			continue;
+		Enqueue(current);
+		if (m_Known[IndexOf(current)])
+			continue;
+		m_Known[IndexOf(current)] = true;
+		for (auto pos : AroundPointView(current, m_Game.GetSize()))
+		{
+			if (cell.AroundMines == 0)
+				m_Discovering.emplace_back(pos);
+			else
+				Enqueue(pos);
+		}
+	}
+}
+
+bool Solver::Examine(const Point& loc)
+{
+	const auto& cell = m_Game.GetCell(loc);
+	uint32_t unknowns = 0;
+	uint32_t flags = 0;
+	for (auto pos : AroundPointView(loc, m_Game.GetSize()))
+	{
+		const auto state = m_Game.GetCell(pos).State;
+		if (state == CellState::Closed)
+			unknowns++;
+		else if (state == CellState::Flagged)
+			flags++;
+	}
+	if (unknowns == 0)
+		return false;
+	const uint32_t mines = cell.AroundMines - flags;
+	// 残りの地雷がない: 未確定のセルはすべて安全
+	if (mines == 0)
+	{
+		m_Statistics.OpenActions++;
+		const auto opened = m_Game.OpenCellsWithMineIndicator(loc);
+		m_Statistics.OpenedCells += opened;
+		for (auto pos : AroundPointView(loc, m_Game.GetSize()))
+			Discover(pos);
+		return true;
+	}
+	// 未確定のセルの数と残りの地雷の数が等しい: 未確定のセルはすべて地雷
+	if (mines == unknowns)
+	{
+		for (auto pos : AroundPointView(loc, m_Game.GetSize()))
+		{
+			if (IsUnknown(pos))
+				FlagMine(pos);
+		}
+		return true;
+	}
+	return ExamineSubsets(loc, unknowns, mines);
+}
+
+bool Solver::ExamineSubsets(const Point& loc, uint32_t unknowns, uint32_t mines)
+{
+	// 未確定のセルを共有し得るのは 5x5 の範囲にある数字のセルに限られる
+	const auto& size = m_Game.GetSize();
+	const uint32_t left = loc.X >= 2 ? loc.X - 2 : 0;
+	const uint32_t top = loc.Y >= 2 ? loc.Y - 2 : 0;
+	const uint32_t right = std::min(loc.X + 2, size.Width - 1);
+	const uint32_t bottom = std::min(loc.Y + 2, size.Height - 1);
+	for (uint32_t y = top; y <= bottom; y++)
+	{
+		for (uint32_t x = left; x <= right; x++)
+		{
+			const Point other(x, y);
+			const auto& otherCell = m_Game.GetCell(other);
+			if (other == loc || otherCell.State != CellState::Open || otherCell.AroundMines == 0)
+				continue;
+			uint32_t shared = 0;
+			for (auto pos : AroundPointView(loc, size))
+			{
+				if (IsUnknown(pos) && Game::IsAround(pos, other))
+					shared++;
+			}
+			if (shared == 0)
+				continue;
+			uint32_t otherUnknowns = 0;
+			uint32_t otherFlags = 0;
+			for (auto pos : AroundPointView(other, size))
+			{
+				const auto state = m_Game.GetCell(pos).State;
+				if (state == CellState::Closed)
+					otherUnknowns++;
+				else if (state == CellState::Flagged)
+					otherFlags++;
+			}
+			const uint32_t otherMines = otherCell.AroundMines - otherFlags;
+			// 一方の未確定セルがすべて他方の周囲にあれば、他方にだけ接するセルにはちょうど差の数だけ地雷がある
+			if (shared == unknowns && otherUnknowns > unknowns && ResolveRest(other, loc, otherUnknowns - unknowns, otherMines - mines))
+				return true;
+			if (shared == otherUnknowns && unknowns > otherUnknowns && ResolveRest(loc, other, unknowns - otherUnknowns, mines - otherMines))
+				return true;
+		}
+	}
+	return false;
+}
+
+bool Solver::ResolveRest(const Point& center, const Point& excluded, uint32_t unknowns, uint32_t mines)
+{
+	if (mines != 0 && mines != unknowns)
+		return false;
+	for (auto pos : AroundPointView(center, m_Game.GetSize()))
+	{
+		if (!IsUnknown(pos) || Game::IsAround(pos, excluded))
+			continue;
+		if (mines == 0)
+			OpenSafeCell(pos);
+		else
+			FlagMine(pos);
+	}
+	return true;
+}
+
+void Solver::OpenSafeCell(const Point& loc)
+{
+	if (!IsUnknown(loc))
+		return;
+	m_Statistics.OpenActions++;
+	m_Statistics.OpenedCells += m_Game.OpenCell(loc);
+	Discover(loc);
+}
+
+void Solver::FlagMine(const Point& loc)
+{
+	m_Statistics.FlagActions++;
+	m_Game.SwitchFlaggedState(loc);
+	EnqueueAround(loc);
+}
@@ -0,0 +1,55 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Game.h"
+
+struct SolverStatistics
+{
+	constexpr SolverStatistics() : OpenActions(0), FlagActions(0), OpenedCells(0) { }
+
+	size_t OpenActions;
+	size_t FlagActions;
+	size_t OpenedCells;
+};
+
+// 開いているセルの数字と旗から確実に安全なセル・地雷のあるセルを推論して Game を操作する
+// 推論には単一の数字による規則と、隣り合う 2 つの数字の一方の未確定セルが他方に含まれる場合の規則を用いる
+// 旗はすべて正しい位置に立てられていることを前提とする
+class Solver
+{
+public:
+	explicit Solver(Game& game);
+
+	// Game::Reset の後などに、盤面の状態を読み直す（確保したメモリは再利用する）
+	void Reset();
+
+	// loc を開いて新しく開いたセルを制約に取り込み、開いたセルの数を返す（推論できないときの推測手に使う）
+	size_t Open(const Point& loc);
+	// 推論できなくなるまで安全なセルを開き、地雷のあるセルに旗を立てる。行った操作の数を返す
+	size_t Solve();
+	constexpr const SolverStatistics& GetStatistics() const { return m_Statistics; }
+
+private:
+	Game& m_Game;
+	// Solver が開いていることを把握済みのセル
+	std::vector<bool> m_Known;
+	// 周囲が変化したため再検討する数字のセル
+	std::vector<Point> m_Pending;
+	std::vector<bool> m_IsPending;
+	std::vector<Point> m_Discovering;
+	SolverStatistics m_Statistics;
+
+	constexpr size_t IndexOf(const Point& loc) const { return static_cast<size_t>(loc.Y) * m_Game.GetSize().Width + loc.X; }
+	constexpr bool IsUnknown(const Point& loc) const { return m_Game.GetCell(loc).State == CellState::Closed; }
+
+	void Enqueue(const Point& loc);
+	void EnqueueAround(const Point& loc);
+	void Discover(const Point& loc);
+	bool Examine(const Point& loc);
+	bool ExamineSubsets(const Point& loc, uint32_t unknowns, uint32_t mines);
+	bool ResolveRest(const Point& center, const Point& excluded, uint32_t unknowns, uint32_t mines);
+	void OpenSafeCell(const Point& loc);
+	void FlagMine(const Point& loc);
+};
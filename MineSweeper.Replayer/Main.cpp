@@ -0,0 +1,106 @@
+﻿#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include "Game.h"
+#include "GameRecord.h"
+
+namespace
+{
+	const char* ToString(GameProgress progress)
+	{
+		switch (progress)
+		{
+		case GameProgress::Completed: return "completed";
+		case GameProgress::Failed   : return "failed";
+		default                     : return "in-progress";
+		}
+	}
+}
+
+// 使い方: MineSweeper.Replayer [--repeat 回数] 記録ファイル...
+int main(int argc, char* argv[])
+{
+	int first = 1;
+	uint32_t repeats = 1;
+	if (argc > 2 && std::string_view(argv[1]) == "--repeat")
+	{
+		const std::string_view text(argv[2]);
+		const auto result = std::from_chars(text.data(), text.data() + text.size(), repeats);
+		if (result.ec != std::errc() || result.ptr != text.data() + text.size() || repeats == 0)
+			first = argc;
+		else
+			first = 3;
+	}
+	if (first >= argc)
+	{
+		std::fprintf(stderr, "Usage: %s [--repeat count] records...\n", argv[0]);
+		return 1;
+	}
+
+	std::vector<GameRecord> records;
+	std::vector<const char*> paths;
+	int exitCode = 0;
+	for (int i = first; i < argc; i++)
+	{
+		std::ifstream stream(argv[i], std::ios::binary);
+		const std::vector<uint8_t> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+		try
+		{
+			if (!stream.good() && !stream.eof())
+				throw std::invalid_argument("The file could not be read.");
+			records.emplace_back(GameRecord::Deserialize(data));
+			paths.emplace_back(argv[i]);
+		}
+		catch (const std::exception& ex)
+		{
+			std::fprintf(stderr, "%s: %s\n", argv[i], ex.what());
+			exitCode = 1;
+		}
+	}
+
+	// 同じ大きさと地雷数の記録が続く間は盤面を作り直さずに再生する
+	// 盤面を確保できないなどで再生できなかった記録は、以降の繰り返しでは飛ばす
+	std::optional<Game> game;
+	std::vector<std::optional<GameProgress>> results(records.size());
+	std::vector<bool> failed(records.size());
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32_t repeat = 0; repeat < repeats; repeat++)
+	{
+		for (size_t i = 0; i < records.size(); i++)
+		{
+			if (failed[i])
+				continue;
+			try
+			{
+				if (!game || game->GetSize() != records[i].GetSize() || game->GetMines() != records[i].GetMines())
+				{
+					game.reset();
+					game.emplace(records[i].CreateGame());
+				}
+				results[i] = records[i].Replay(*game);
+			}
+			catch (const std::exception& ex)
+			{
+				std::fprintf(stderr, "%s: %s\n", paths[i], ex.what());
+				failed[i] = true;
+				exitCode = 1;
+			}
+		}
+	}
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		const auto& record = records[i];
+		std::printf("%ux%u mines=%u seed=%llu actions=%zu result=%s\n", record.GetSize().Width, record.GetSize().Height, record.GetMines(), static_cast<unsigned long long>(record.GetSeed()), record.GetActions().size(), results[i] ? ToString(*results[i]) : "error");
+	}
+	const auto games = static_cast<double>(records.size()) * repeats;
+	std::printf("%.0f games replayed in %.3f s (%.0f games/s)\n", games, elapsed, elapsed > 0 ? games / elapsed : 0.0);
+	return exitCode;
+}
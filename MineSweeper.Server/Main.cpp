@@ -0,0 +1,55 @@
+﻿#include <charconv>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include "GameServer.h"
+
+// 使い方: MineSweeper.Server [スレッド数]
+// 標準入力から 1 行に 1 つのコマンドを読み、応答を 1 行ずつ標準出力に書く（形式は GameServer.h を参照）
+// 応答は異なるセッションの間では実行を終えた順に返るので、<tag> で要求と対応付ける
+int main(int argc, char* argv[])
+{
+	uint32_t threads = 0;
+	if (argc > 2 || (argc == 2 && std::from_chars(argv[1], argv[1] + std::char_traits<char>::length(argv[1]), threads).ec != std::errc()))
+	{
+		std::fprintf(stderr, "Usage: %s [threads]\n", argv[0]);
+		return 1;
+	}
+	std::ios::sync_with_stdio(false);
+	// 応答はスレッドごとに溜め、ワーカーが溜まっていたコマンドを実行し終えたところでまとめて書き出す
+	// 応答を待ってから次の要求を送るクライアントのため、書き出すたびにフラッシュする
+	std::mutex outputMutex;
+	thread_local std::string pendingReplies;
+	const auto flush = [&outputMutex]()
+	{
+		if (pendingReplies.empty())
+			return;
+		{
+			std::lock_guard lock(outputMutex);
+			std::fwrite(pendingReplies.data(), 1, pendingReplies.size(), stdout);
+			std::fflush(stdout);
+		}
+		pendingReplies.clear();
+	};
+	{
+		GameServer server(threads,
+			[](std::string_view reply)
+			{
+				pendingReplies.append(reply);
+				pendingReplies.push_back('\n');
+			},
+			flush);
+		std::string line;
+		while (std::getline(std::cin, line))
+		{
+			if (line.find_first_not_of(" \t\r") == std::string::npos)
+				continue;
+			server.Submit(line);
+			// 形式の誤りはこのスレッドで応答される
+			flush();
+		}
+	}
+	return 0;
+}
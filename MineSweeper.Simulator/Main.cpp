@@ -0,0 +1,56 @@
+﻿#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+#include "Simulation.h"
+
+namespace
+{
+	template <typename T> bool ParseArgument(std::string_view text, T& value)
+	{
+		const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+		return result.ec == std::errc() && result.ptr == text.data() + text.size();
+	}
+}
+
+// 使い方: MineSweeper.Simulator [幅 高さ 地雷数 [ゲーム数 [スレッド数 [シード]]]]
+int main(int argc, char* argv[])
+{
+	SimulationOptions options;
+	bool valid = argc == 1 || (argc >= 4 && argc <= 7);
+	if (valid && argc >= 4)
+	{
+		valid = ParseArgument(argv[1], options.Size.Width) &&
+			ParseArgument(argv[2], options.Size.Height) &&
+			ParseArgument(argv[3], options.Mines);
+	}
+	if (valid && argc >= 5)
+		valid = ParseArgument(argv[4], options.Games);
+	if (valid && argc >= 6)
+		valid = ParseArgument(argv[5], options.Threads);
+	if (valid && argc >= 7)
+	{
+		uint64_t seed = 0;
+		valid = ParseArgument(argv[6], seed);
+		options.Seed = seed;
+	}
+	if (!valid || options.Size.Width == 0 || options.Size.Height == 0 || static_cast<uint64_t>(options.Mines) >= static_cast<uint64_t>(options.Size.Width) * options.Size.Height)
+	{
+		std::fprintf(stderr, "Usage: %s [width height mines [games [threads [seed]]]]\n", argv[0]);
+		return 1;
+	}
+
+	const auto result = RunSimulation(options);
+	const auto games = static_cast<double>(std::max<uint64_t>(result.Games, 1));
+	const auto elapsed = std::chrono::duration<double>(result.Elapsed).count();
+	std::printf("board          %ux%u, %u mines\n", options.Size.Width, options.Size.Height, options.Mines);
+	std::printf("games          %llu\n", static_cast<unsigned long long>(result.Games));
+	std::printf("win rate       %.3f%%\n", 100.0 * result.Wins / games);
+	std::printf("no-guess games %.3f%%\n", 100.0 * (result.Games - result.GuessedGames) / games);
+	std::printf("clicks/game    %.2f\n", result.Clicks / games);
+	std::printf("guesses/game   %.3f\n", result.Guesses / games);
+	std::printf("time/game      %.3f us\n", std::chrono::duration<double, std::micro>(result.GameTime).count() / games);
+	std::printf("elapsed        %.3f s (%.0f games/s)\n", elapsed, result.Games / elapsed);
+	return 0;
+}
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <cstdint>
+#include <stdexcept>
 #include <string>
 #include <optional>
+#include <type_traits>
 #include <variant>
+#include <vector>
+#ifdef _WIN32
 #include "Utility.h"
+#endif
 
 enum class ConsoleColor : uint8_t
 {
@@ -31,7 +37,7 @@ struct ConsoleCharacterAttribute
 {
 	constexpr ConsoleCharacterAttribute() : Foreground(ConsoleColor::Black), Background(ConsoleColor::Black) { }
 	constexpr ConsoleCharacterAttribute(ConsoleColor foreground, ConsoleColor background) : Foreground(foreground), Background(background) { }
-	constexpr explicit ConsoleCharacterAttribute(uint16_t value) : Foreground(static_cast<ConsoleColor>(value & ConsoleColorMask)), Background(static_cast<ConsoleColor>((value << 4) & ConsoleColorMask)) { }
+	constexpr explicit ConsoleCharacterAttribute(uint16_t value) : Foreground(static_cast<ConsoleColor>(value & ConsoleColorMask)), Background(static_cast<ConsoleColor>((value >> 4) & ConsoleColorMask)) { }
 
 	ConsoleColor Foreground;
 	ConsoleColor Background;
@@ -43,38 +49,52 @@ struct ConsoleCoordinate
 {
 	constexpr ConsoleCoordinate() : X(0), Y(0) { }
 	constexpr ConsoleCoordinate(int16_t x, int16_t y) : X(x), Y(y) { }
+#ifdef _WIN32
 	constexpr explicit ConsoleCoordinate(COORD value) : X(value.X), Y(value.Y) { }
+#endif
 
 	int16_t X;
 	int16_t Y;
 
+	constexpr bool operator ==(const ConsoleCoordinate& right) const { return X == right.X && Y == right.Y; }
+	constexpr bool operator !=(const ConsoleCoordinate& right) const { return !(*this == right); }
+#ifdef _WIN32
 	constexpr explicit operator COORD() const { return { X, Y }; }
+#endif
 };
 
 struct ConsoleSize
 {
 	constexpr ConsoleSize() : Width(0), Height(0) { }
 	constexpr ConsoleSize(int16_t width, int16_t height) : Width(width), Height(height) { }
+#ifdef _WIN32
 	constexpr explicit ConsoleSize(COORD value) : Width(value.X), Height(value.Y) { }
+#endif
 
 	int16_t Width;
 	int16_t Height;
 
+#ifdef _WIN32
 	constexpr explicit operator COORD() const { return { Width, Height }; }
+#endif
 };
 
 struct ConsoleRect
 {
 	constexpr ConsoleRect() : Left(0), Top(0), Right(0), Bottom(0) { }
 	constexpr ConsoleRect(int16_t left, int16_t top, int16_t right, int16_t bottom) : Left(left), Top(top), Right(right), Bottom(bottom) { }
+#ifdef _WIN32
 	constexpr explicit ConsoleRect(SMALL_RECT value) : Left(value.Left), Top(value.Top), Right(value.Right), Bottom(value.Bottom) { }
+#endif
 
 	int16_t Left;
 	int16_t Top;
 	int16_t Right;
 	int16_t Bottom;
 
+#ifdef _WIN32
 	constexpr explicit operator SMALL_RECT() const { return { Left, Top, Right, Bottom }; }
+#endif
 };
 
 enum class FontFamilyType : uint8_t 
@@ -90,7 +110,9 @@ enum class FontFamilyType : uint8_t
 struct ConsoleFontInfo
 {
 	constexpr ConsoleFontInfo() : Index(0), PitchAndFamily(0), Weight(0) { }
+#ifdef _WIN32
 	constexpr explicit ConsoleFontInfo(const CONSOLE_FONT_INFOEX& value) : Index(value.nFont), Size(value.dwFontSize), PitchAndFamily(value.FontFamily), Weight(value.FontWeight), FaceName(value.FaceName) { }
+#endif
 
 	uint32_t Index;
 	ConsoleSize Size;
@@ -98,17 +120,18 @@ struct ConsoleFontInfo
 	uint32_t Weight;
 	std::wstring FaceName;
 
-	constexpr bool GetIsFixedPitch() const { return GetFlag(PitchAndFamily, TMPF_FIXED_PITCH); }
-	constexpr void SetIsFixedPitch(bool value) { SetFlag(PitchAndFamily, TMPF_FIXED_PITCH, value); }
-	constexpr bool GetIsVector() const { return GetFlag(PitchAndFamily, TMPF_VECTOR); }
-	constexpr void SetIsVector(bool value) { SetFlag(PitchAndFamily, TMPF_VECTOR, value); }
-	constexpr bool GetIsTrueType() const { return GetFlag(PitchAndFamily, TMPF_TRUETYPE); }
-	constexpr void SetIsTrueType(bool value) { SetFlag(PitchAndFamily, TMPF_TRUETYPE, value); }
-	constexpr bool GetIsDevice() const { return GetFlag(PitchAndFamily, TMPF_DEVICE); }
-	constexpr void SetIsDevice(bool value) { SetFlag(PitchAndFamily, TMPF_DEVICE, value); }
+	constexpr bool GetIsFixedPitch() const { return GetFlag(PitchAndFamily, FixedPitchFlag); }
+	constexpr void SetIsFixedPitch(bool value) { SetFlag(PitchAndFamily, FixedPitchFlag, value); }
+	constexpr bool GetIsVector() const { return GetFlag(PitchAndFamily, VectorFlag); }
+	constexpr void SetIsVector(bool value) { SetFlag(PitchAndFamily, VectorFlag, value); }
+	constexpr bool GetIsTrueType() const { return GetFlag(PitchAndFamily, TrueTypeFlag); }
+	constexpr void SetIsTrueType(bool value) { SetFlag(PitchAndFamily, TrueTypeFlag, value); }
+	constexpr bool GetIsDevice() const { return GetFlag(PitchAndFamily, DeviceFlag); }
+	constexpr void SetIsDevice(bool value) { SetFlag(PitchAndFamily, DeviceFlag, value); }
 	constexpr FontFamilyType GetFamilyType() const { return static_cast<FontFamilyType>(PitchAndFamily >> 4); }
-	constexpr void SetFamilyType(FontFamilyType value) { PitchAndFamily = PitchAndFamily & 0xF | static_cast<uint32_t>(value) << 4; }
+	constexpr void SetFamilyType(FontFamilyType value) { PitchAndFamily = (PitchAndFamily & 0xF) | static_cast<uint32_t>(value) << 4; }
 
+#ifdef _WIN32
 	constexpr explicit operator CONSOLE_FONT_INFOEX() const
 	{
 		CONSOLE_FONT_INFOEX info;
@@ -125,8 +148,15 @@ struct ConsoleFontInfo
 		auto size = FaceName.copy(info.FaceName, sizeof(info.FaceName) / sizeof(info.FaceName[0]) - 1);
 		info.FaceName[size] = L'\0';
 	}
+#endif
 
 private:
+	// TMPF_FIXED_PITCH, TMPF_VECTOR, TMPF_TRUETYPE, TMPF_DEVICE
+	constexpr static uint32_t FixedPitchFlag = 0x01;
+	constexpr static uint32_t VectorFlag = 0x02;
+	constexpr static uint32_t TrueTypeFlag = 0x04;
+	constexpr static uint32_t DeviceFlag = 0x08;
+
 	template <typename T, typename TValue> constexpr static bool GetFlag(T storage, TValue flag) { return storage & static_cast<T>(flag); }
 	template <typename T, typename TValue> constexpr static void SetFlag(T& storage, TValue flag, bool set)
 	{
@@ -147,49 +177,49 @@ private:
 enum class ConsoleOutputModes : uint32_t
 {
 	Default = 0,
-	EnableProcessedOutput = ENABLE_PROCESSED_OUTPUT,
-	EnableWrapAtEolOutput = ENABLE_WRAP_AT_EOL_OUTPUT,
-	EnableVirtualTerminalProcessing = ENABLE_VIRTUAL_TERMINAL_PROCESSING,
-	DisableNewLineAutoReturn = DISABLE_NEWLINE_AUTO_RETURN,
-	EnableLvbGridWorldWide = ENABLE_LVB_GRID_WORLDWIDE,
+	EnableProcessedOutput = 0x0001,
+	EnableWrapAtEolOutput = 0x0002,
+	EnableVirtualTerminalProcessing = 0x0004,
+	DisableNewLineAutoReturn = 0x0008,
+	EnableLvbGridWorldWide = 0x0010,
 };
 ALLOW_ENUM_FLAG_OPERATIONS(ConsoleOutputModes)
 
 enum class ConsoleInputModes : uint32_t
 {
 	Default = 0,
-	EnableProcessedInput = ENABLE_PROCESSED_INPUT,
-	EnableLineInput = ENABLE_LINE_INPUT,
-	EnableEchoInput = ENABLE_ECHO_INPUT,
-	EnableWindowInput = ENABLE_WINDOW_INPUT,
-	EnableMouseInput = ENABLE_MOUSE_INPUT,
-	EnableInsertMode = ENABLE_INSERT_MODE,
-	EnableQuickEditMode = ENABLE_QUICK_EDIT_MODE,
-	EnableExtendedFlags = ENABLE_EXTENDED_FLAGS,
-	EnableAutoPosition = ENABLE_AUTO_POSITION,
-	EnableVirtualTerminalInput = ENABLE_VIRTUAL_TERMINAL_INPUT,
+	EnableProcessedInput = 0x0001,
+	EnableLineInput = 0x0002,
+	EnableEchoInput = 0x0004,
+	EnableWindowInput = 0x0008,
+	EnableMouseInput = 0x0010,
+	EnableInsertMode = 0x0020,
+	EnableQuickEditMode = 0x0040,
+	EnableExtendedFlags = 0x0080,
+	EnableAutoPosition = 0x0100,
+	EnableVirtualTerminalInput = 0x0200,
 };
 ALLOW_ENUM_FLAG_OPERATIONS(ConsoleInputModes)
 
 enum class ConsoleControlKeyStates : uint32_t
 {
 	None = 0,
-	RightAlt = RIGHT_ALT_PRESSED,
-	LeftAlt = LEFT_ALT_PRESSED,
-	RightCtrl = RIGHT_CTRL_PRESSED,
-	LeftCtrl = LEFT_CTRL_PRESSED,
-	Shift = SHIFT_PRESSED,
-	NumLock = NUMLOCK_ON,
-	ScrollLock = SCROLLLOCK_ON,
-	CapsLock = CAPSLOCK_ON,
-	EnhancedKey = ENHANCED_KEY,
-	DbcsChar = NLS_DBCSCHAR,
-	AlphaNumeric = NLS_ALPHANUMERIC,
-	Katakana = NLS_KATAKANA,
-	Hiragana = NLS_HIRAGANA,
-	Roman = NLS_ROMAN,
-	ImeConversion = NLS_IME_CONVERSION,
-	ImeDisable = NLS_IME_DISABLE,
+	RightAlt = 0x0001,
+	LeftAlt = 0x0002,
+	RightCtrl = 0x0004,
+	LeftCtrl = 0x0008,
+	Shift = 0x0010,
+	NumLock = 0x0020,
+	ScrollLock = 0x0040,
+	CapsLock = 0x0080,
+	EnhancedKey = 0x0100,
+	DbcsChar = 0x00010000,
+	AlphaNumeric = 0x00000000,
+	Katakana = 0x00020000,
+	Hiragana = 0x00040000,
+	Roman = 0x00400000,
+	ImeConversion = 0x00800000,
+	ImeDisable = 0x20000000,
 };
 ALLOW_ENUM_FLAG_OPERATIONS(ConsoleControlKeyStates)
 
@@ -197,6 +227,7 @@ struct KeyEventRecord
 {
 public:
 	constexpr KeyEventRecord() : IsKeyDown(false), RepeatCount(0), VirtualKeyCode(0), VirtualScanCode(0), Char(L'\0'), ControlKeyState(ConsoleControlKeyStates::None) { }
+#ifdef _WIN32
 	constexpr KeyEventRecord(const KEY_EVENT_RECORD& record) :
 		IsKeyDown(record.bKeyDown),
 		RepeatCount(record.wRepeatCount),
@@ -204,22 +235,23 @@ public:
 		VirtualScanCode(record.wVirtualScanCode),
 		Char(record.uChar.UnicodeChar),
 		ControlKeyState(static_cast<ConsoleControlKeyStates>(record.dwControlKeyState)) { }
+#endif
 
 	bool IsKeyDown;
 	uint16_t RepeatCount;
 	uint16_t VirtualKeyCode;
 	uint16_t VirtualScanCode;
-	WCHAR Char;
+	wchar_t Char;
 	ConsoleControlKeyStates ControlKeyState;
 };
 
 enum class MouseEventKind : uint32_t
 {
 	PressedOrReleased = 0,
-	Moved = MOUSE_MOVED,
-	DoubleClicked = DOUBLE_CLICK,
-	VerticallyWheeled = MOUSE_WHEELED,
-	HorizontallyWheeled = MOUSE_HWHEELED,
+	Moved = 0x0001,
+	DoubleClicked = 0x0002,
+	VerticallyWheeled = 0x0004,
+	HorizontallyWheeled = 0x0008,
 };
 
 struct MouseButtonState
@@ -287,12 +319,14 @@ private:
 struct MouseEventRecord
 {
 	constexpr MouseEventRecord() : Location(), ButtonState(), Delta(0), ControlKeyState(ConsoleControlKeyStates::None), Kind(MouseEventKind::PressedOrReleased) { }
+#ifdef _WIN32
 	constexpr MouseEventRecord(const MOUSE_EVENT_RECORD& record) :
 		Location(record.dwMousePosition),
 		ButtonState(record.dwButtonState & 0xFFFF),
 		Delta(static_cast<int16_t>(record.dwButtonState >> 16)),
 		ControlKeyState(static_cast<ConsoleControlKeyStates>(record.dwControlKeyState)),
 		Kind(static_cast<MouseEventKind>(record.dwEventFlags)) { }
+#endif
 
 	ConsoleCoordinate Location;
 	MouseButtonState ButtonState;
@@ -304,7 +338,10 @@ struct MouseEventRecord
 struct BufferEventRecord
 {
 	constexpr BufferEventRecord() : Size() { }
+	constexpr BufferEventRecord(ConsoleSize size) : Size(size) { }
+#ifdef _WIN32
 	constexpr BufferEventRecord(const WINDOW_BUFFER_SIZE_RECORD& record) : Size(record.dwSize) { }
+#endif
 
 	ConsoleSize Size;
 };
@@ -312,7 +349,9 @@ struct BufferEventRecord
 struct MenuEventRecord
 {
 	constexpr MenuEventRecord() : CommandId(0) { }
+#ifdef _WIN32
 	constexpr MenuEventRecord(const MENU_EVENT_RECORD& record) : CommandId(record.dwCommandId) { }
+#endif
 
 	uint32_t CommandId;
 };
@@ -320,283 +359,17 @@ struct MenuEventRecord
 struct FocusEventRecord
 {
 	constexpr FocusEventRecord() : IsSetFocus(false) { }
+#ifdef _WIN32
 	constexpr FocusEventRecord(const FOCUS_EVENT_RECORD& record) : IsSetFocus(record.bSetFocus) { }
+#endif
 
 	bool IsSetFocus;
 };
 
 using EventRecord = std::variant<std::monostate, KeyEventRecord, MouseEventRecord, BufferEventRecord, MenuEventRecord, FocusEventRecord>;
 
-constexpr inline EventRecord CreateEventRecord(const INPUT_RECORD& record)
-{
-	EventRecord eventRecord;
-	switch (record.EventType)
-	{
-	case KEY_EVENT               : eventRecord.emplace<KeyEventRecord   >(record.Event.KeyEvent             ); break;
-	case MOUSE_EVENT             : eventRecord.emplace<MouseEventRecord >(record.Event.MouseEvent           ); break;
-	case WINDOW_BUFFER_SIZE_EVENT: eventRecord.emplace<BufferEventRecord>(record.Event.WindowBufferSizeEvent); break;
-	case MENU_EVENT              : eventRecord.emplace<MenuEventRecord  >(record.Event.MenuEvent            ); break;
-	case FOCUS_EVENT             : eventRecord.emplace<FocusEventRecord >(record.Event.FocusEvent           ); break;
-	default: _ASSERT_EXPR(false, "Unreachable"); break;
-	}
-	return eventRecord;
-}
-
-class ConsoleBase abstract
-{
-public:
-	ConsoleBase(HANDLE handle) : m_Handle(handle) { }
-	ConsoleBase(DWORD kind) : m_Handle(GetHandle(kind)) { }
-	ConsoleBase(const ConsoleBase&) = delete;
-	ConsoleBase(ConsoleBase&&) = default;
-	ConsoleBase& operator=(const ConsoleBase&) = delete;
-	ConsoleBase& operator=(ConsoleBase&&) = default;
-
-protected:
-	HANDLE GetHandle() const { return m_Handle; }
-	uint32_t GetModeCore() const
-	{
-		DWORD mode;
-		ThrowIfFailed(GetConsoleMode(m_Handle, &mode));
-		return mode;
-	}
-	void SetModeCore(uint32_t value) { ThrowIfFailed(SetConsoleMode(m_Handle, value)); }
-
-private:
-	HANDLE m_Handle;
-
-	static HANDLE GetHandle(DWORD kind)
-	{
-		auto handle = GetStdHandle(kind);
-		if (handle == INVALID_HANDLE_VALUE)
-			ThrowLastException();
-		return handle;
-	}
-};
-
-class OutputConsole : public ConsoleBase
-{
-public:
-	OutputConsole() : ConsoleBase(STD_OUTPUT_HANDLE) { }
-
-	ConsoleOutputModes GetMode() const { return static_cast<ConsoleOutputModes>(GetModeCore()); }
-	void SetMode(ConsoleOutputModes value) { return SetModeCore(static_cast<uint32_t>(value)); }
-	ConsoleSize GetScreenBufferSize() const
-	{
-		CONSOLE_SCREEN_BUFFER_INFOEX info;
-		GetScreenBufferInfo(info);
-		return ConsoleSize(info.dwSize);
-	}
-	void SetScreenBufferSize(ConsoleSize value) { ThrowIfFailed(SetConsoleScreenBufferSize(GetHandle(), static_cast<COORD>(value))); }
-	ConsoleCoordinate GetCursorPosition() const
-	{
-		CONSOLE_SCREEN_BUFFER_INFOEX info;
-		GetScreenBufferInfo(info);
-		return ConsoleCoordinate(info.dwCursorPosition);
-	}
-	void SetCursorPosition(ConsoleCoordinate position) { ThrowIfFailed(SetConsoleCursorPosition(GetHandle(), static_cast<COORD>(position))); }
-	uint32_t GetCursorSize() const
-	{
-		CONSOLE_CURSOR_INFO info;
-		ThrowIfFailed(GetConsoleCursorInfo(GetHandle(), &info));
-		return info.dwSize;
-	}
-	void SetCursorSize(uint32_t value)
-	{
-		CONSOLE_CURSOR_INFO info;
-		ThrowIfFailed(GetConsoleCursorInfo(GetHandle(), &info));
-		info.dwSize = value;
-		ThrowIfFailed(SetConsoleCursorInfo(GetHandle(), &info));
-	}
-	bool GetIsCursorVisible() const
-	{
-		CONSOLE_CURSOR_INFO info;
-		ThrowIfFailed(GetConsoleCursorInfo(GetHandle(), &info));
-		return info.bVisible;
-	}
-	void SetIsCursorVisible(bool value)
-	{
-		CONSOLE_CURSOR_INFO info;
-		ThrowIfFailed(GetConsoleCursorInfo(GetHandle(), &info));
-		info.bVisible = value;
-		ThrowIfFailed(SetConsoleCursorInfo(GetHandle(), &info));
-	}
-	ConsoleRect GetWindowBounds() const
-	{
-		CONSOLE_SCREEN_BUFFER_INFOEX info;
-		GetScreenBufferInfo(info);
-		return ConsoleRect(info.srWindow);
-	}
-	void SetWindowBounds(bool absolute, const ConsoleRect& bounds)
-	{
-		auto rect = static_cast<SMALL_RECT>(bounds);
-		ThrowIfFailed(SetConsoleWindowInfo(GetHandle(), absolute, &rect));
-	}
-	ConsoleSize GetMaximumWindowSize() const
-	{
-		CONSOLE_SCREEN_BUFFER_INFOEX info;
-		GetScreenBufferInfo(info);
-		return ConsoleSize(info.dwMaximumWindowSize);
-	}
-	ConsoleCharacterAttribute GetTextAttribute() const
-	{
-		CONSOLE_SCREEN_BUFFER_INFOEX info;
-		GetScreenBufferInfo(info);
-		return ConsoleCharacterAttribute(info.wAttributes);
-	}
-	void SetTextAttribute(ConsoleCharacterAttribute value) { ThrowIfFailed(SetConsoleTextAttribute(GetHandle(), static_cast<uint16_t>(value))); }
-	ConsoleCharacterAttribute GetPopupAttribute() const
-	{
-		CONSOLE_SCREEN_BUFFER_INFOEX info;
-		GetScreenBufferInfo(info);
-		return ConsoleCharacterAttribute(info.wPopupAttributes);
-	}
-	bool IsFullScreenSupported() const
-	{
-		CONSOLE_SCREEN_BUFFER_INFOEX info;
-		GetScreenBufferInfo(info);
-		return info.bFullscreenSupported;
-	}
-	std::vector<COLORREF> GetColorTable() const
-	{
-		CONSOLE_SCREEN_BUFFER_INFOEX info;
-		GetScreenBufferInfo(info);
-		return std::vector<COLORREF>(info.ColorTable, info.ColorTable + sizeof(info.ColorTable) / sizeof(info.ColorTable[0]));
-	}
-	ConsoleFontInfo GetCurrentFont(bool maximumWindow) const
-	{
-		CONSOLE_FONT_INFOEX info{ sizeof(CONSOLE_FONT_INFOEX) };
-		ThrowIfFailed(GetCurrentConsoleFontEx(GetHandle(), maximumWindow, &info));
-		return ConsoleFontInfo(info);
-	}
-	void SetCurrentFont(bool maximumWindow, const ConsoleFontInfo& value)
-	{
-		CONSOLE_FONT_INFOEX info;
-		value.CopyTo(info);
-		ThrowIfFailed(SetCurrentConsoleFontEx(GetHandle(), maximumWindow, &info));
-	}
-
-	uint32_t FillOutput(WCHAR character, uint32_t length, ConsoleCoordinate coord)
-	{
-		DWORD actualLength;
-		ThrowIfFailed(FillConsoleOutputCharacterW(GetHandle(), character, length, static_cast<COORD>(coord), &actualLength));
-		return actualLength;
-	}
-	uint32_t FillOutput(ConsoleCharacterAttribute attribute, uint32_t length, ConsoleCoordinate coord)
-	{
-		DWORD actualLength;
-		ThrowIfFailed(FillConsoleOutputAttribute(GetHandle(), static_cast<uint16_t>(attribute), length, static_cast<COORD>(coord), &actualLength));
-		return actualLength;
-	}
-	uint32_t WriteOutput(std::wstring_view characters, ConsoleCoordinate coord)
-	{
-		DWORD actualLength;
-		ThrowIfFailed(WriteConsoleOutputCharacterW(GetHandle(), characters.data(), static_cast<DWORD>(characters.size()), static_cast<COORD>(coord), &actualLength));
-		return actualLength;
-	}
-	template <typename InputIterator> uint32_t WriteOutput(InputIterator attributesBegin, InputIterator attributesEnd, ConsoleCoordinate coord)
-	{
-		std::vector<uint16_t> buffer;
-		std::transform(attributesBegin, attributesEnd, std::back_insert_iterator(buffer), [](const ConsoleCharacterAttribute& attr) { return static_cast<uint16_t>(attr); });
-		DWORD actualLength;
-		ThrowIfFailed(WriteConsoleOutputAttribute(m_Handle, buffer.data(), static_cast<DWORD>(buffer.size()), static_cast<COORD>(coord), &actualLength));
-		return actualLength;
-	}
-	uint32_t Write(std::wstring_view text)
-	{
-		DWORD actualLength;
-		ThrowIfFailed(WriteConsoleW(GetHandle(), text.data(), static_cast<DWORD>(text.size()), &actualLength, nullptr));
-		return actualLength;
-	}
-
-private:
-	void GetScreenBufferInfo(CONSOLE_SCREEN_BUFFER_INFOEX& value) const
-	{
-		value.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
-		ThrowIfFailed(GetConsoleScreenBufferInfoEx(GetHandle(), &value));
-	}
-};
-
-class InputConsole : public ConsoleBase
-{
-public:
-	InputConsole() : ConsoleBase(STD_INPUT_HANDLE) { }
-
-	ConsoleInputModes GetMode() const { return static_cast<ConsoleInputModes>(GetModeCore()); }
-	void SetMode(ConsoleInputModes value) { return SetModeCore(static_cast<uint32_t>(value)); }
-	uint32_t GetNumberOfInputEvents() const
-	{
-		DWORD numberOfEvents;
-		ThrowIfFailed(GetNumberOfConsoleInputEvents(GetHandle(), &numberOfEvents));
-		return numberOfEvents;
-	}
-	uint32_t PeekInput(INPUT_RECORD* buffer, uint32_t length) const { return PeekReadInput(PeekConsoleInputW, GetHandle(), buffer, length); }
-	std::optional<EventRecord> PeekInput() const
-	{
-		INPUT_RECORD inputRecord;
-		std::optional<EventRecord> value;
-		if (PeekReadInput(PeekConsoleInputW, GetHandle(), &inputRecord, 1) != 0)
-			value = CreateEventRecord(inputRecord);
-		return value;
-	}
-	std::vector<EventRecord> PeekInput(uint32_t length) const { return PeekReadInput(PeekConsoleInputW, GetHandle(), length); }
-	uint32_t ReadInput(INPUT_RECORD* buffer, uint32_t length) { return PeekReadInput(ReadConsoleInputW, GetHandle(), buffer, length); }
-	EventRecord ReadInput()
-	{
-		INPUT_RECORD inputRecord;
-		PeekReadInput(ReadConsoleInputW, GetHandle(), &inputRecord, 1);
-		return CreateEventRecord(inputRecord);
-	}
-	std::vector<EventRecord> ReadInput(uint32_t length) { return PeekReadInput(ReadConsoleInputW, GetHandle(), length); }
-	uint32_t Read(WCHAR* buffer, uint32_t length, const std::optional<CONSOLE_READCONSOLE_CONTROL>& control = std::nullopt)
-	{
-		DWORD actualLength;
-		CONSOLE_READCONSOLE_CONTROL* pControl = nullptr;
-		if (control)
-			pControl = const_cast<CONSOLE_READCONSOLE_CONTROL*>(&*control);
-		ThrowIfFailed(ReadConsoleW(GetHandle(), buffer, length, &actualLength, pControl));
-		return actualLength;
-	}
-	std::wstring Read(const std::optional<CONSOLE_READCONSOLE_CONTROL>& control = std::nullopt)
-	{
-		constexpr uint32_t charsToRead = 16;
-		std::wstring buffer;
-		size_t charsReadSoFar = 0;
-		while (true)
-		{
-			buffer.resize(charsReadSoFar + charsToRead);
-			const auto charsRead = Read(buffer.data() + charsReadSoFar, charsToRead, control);
-			charsReadSoFar += charsRead;
-			if (charsRead < charsToRead) break;
-		}
-		buffer.resize(charsReadSoFar);
-		buffer.shrink_to_fit();
-		return std::move(buffer);
-	}
-	void FlushInputBuffer() { ThrowIfFailed(FlushConsoleInputBuffer(GetHandle())); }
-
-	static uint32_t GetNumberOfMouseButtons()
-	{
-		DWORD numberOfMouseButtons;
-		ThrowIfFailed(GetNumberOfConsoleMouseButtons(&numberOfMouseButtons));
-		return numberOfMouseButtons;
-	}
-
-private:
-	using PeekReadFunc = BOOL(WINAPI *)(HANDLE, PINPUT_RECORD, DWORD, LPDWORD);
-
-	static uint32_t PeekReadInput(PeekReadFunc func, HANDLE handle, INPUT_RECORD* buffer, uint32_t length)
-	{
-		DWORD actualLength;
-		ThrowIfFailed(func(handle, buffer, length, &actualLength));
-		return actualLength;
-	}
-	static std::vector<EventRecord> PeekReadInput(PeekReadFunc func, HANDLE handle, uint32_t length)
-	{
-		std::vector<INPUT_RECORD> buffer(length);
-		auto actualLength = PeekReadInput(func, handle, buffer.data(), length);
-		std::vector<EventRecord> records(actualLength);
-		std::transform(buffer.cbegin(), buffer.cbegin() + actualLength, records.begin(), CreateEventRecord);
-		return records;
-	}
-};
\ No newline at end of file
+#ifdef _WIN32
+#include "Win32Console.h"
+#else
+#include "TerminalConsole.h"
+#endif
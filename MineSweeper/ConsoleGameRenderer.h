@@ -0,0 +1,159 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <vector>
+#include "Console.h"
+#include "Game.h"
+#include "Instrumentation.h"
+
+constexpr ConsoleColor DefaultBackground = ConsoleColor::Silver;
+constexpr ConsoleColor DefaultForeground = ConsoleColor::Black;
+
+// TOutputConsole には OutputConsole か、同じ操作を持つ MemoryOutputConsole を指定する
+template <typename TOutputConsole> class ConsoleGameRenderer : public GameRenderer
+{
+public:
+	// 盤面のうち viewportSize の範囲だけを画面に表示する（描画に使うメモリと時間は表示範囲の大きさに比例する）
+	ConsoleGameRenderer(TOutputConsole& output, const Size& boardSize, const Size& viewportSize) :
+		m_Output(output),
+		m_BoardSize(boardSize),
+		m_Viewport(Point(), viewportSize),
+		m_BufferWidth(std::max<uint32_t>(output.GetScreenBufferSize().Width, viewportSize.Width * 2)),
+		m_Characters(static_cast<size_t>(viewportSize.Width) * viewportSize.Height, L' '),
+		m_Attributes(static_cast<size_t>(viewportSize.Width) * viewportSize.Height, { DefaultForeground, DefaultBackground }),
+		m_DirtyTop(viewportSize.Height),
+		m_DirtyBottom(0) { }
+
+	constexpr const Rect& GetViewport() const { return m_Viewport; }
+	std::optional<Point> CoordinateToLocation(ConsoleCoordinate coordinate) const
+	{
+		if (coordinate.X < 0 || coordinate.Y < 0)
+			return std::nullopt;
+		Point offset(static_cast<uint32_t>(coordinate.X / 2), static_cast<uint32_t>(coordinate.Y));
+		if (offset.IsContainedIn(m_Viewport.GetSize()))
+			return { Point(m_Viewport.X + offset.X, m_Viewport.Y + offset.Y) };
+		else
+			return std::nullopt;
+	}
+	// 表示範囲を盤面の内側に収まるように移動し、移動した場合は true を返す
+	bool Scroll(const Vector& delta)
+	{
+		const auto move = [](uint32_t position, int32_t delta, uint32_t limit)
+		{
+			return static_cast<uint32_t>(std::clamp<int64_t>(static_cast<int64_t>(position) + delta, 0, limit));
+		};
+		const Point location(
+			move(m_Viewport.X, delta.X, m_BoardSize.Width - m_Viewport.Width),
+			move(m_Viewport.Y, delta.Y, m_BoardSize.Height - m_Viewport.Height));
+		if (location == m_Viewport.GetLocation())
+			return false;
+		m_Viewport = Rect(location, m_Viewport.GetSize());
+		return true;
+	}
+	// 次の描画から残り地雷数の後に表示する（空にすると消える）
+	void SetMessage(std::wstring message) { m_Message = std::move(message); }
+
+	void BeginFrame() override { }
+	void RenderCell(const Point& loc, const Cell& cell, bool opening) override
+	{
+		if (!m_Viewport.Contains(loc))
+			return;
+		const uint32_t row = loc.Y - m_Viewport.Y;
+		const auto index = static_cast<size_t>(row) * m_Viewport.Width + (loc.X - m_Viewport.X);
+		if (cell.State == CellState::Flagged)
+			Compose(index, L'■', ConsoleColor::Purple);
+		else if (cell.State != CellState::Open)
+			Compose(index, L'■', opening ? ConsoleColor::Black : ConsoleColor::Gray);
+		else if (cell.HasMine)
+			Compose(index, L'●', DefaultForeground);
+		else if (cell.AroundMines == 0)
+			Compose(index, L' ', DefaultForeground);
+		else
+			Compose(index, static_cast<wchar_t>(L'０' + cell.AroundMines), GetColor(cell.AroundMines));
+		m_DirtyTop = std::min(m_DirtyTop, row);
+		m_DirtyBottom = std::max(m_DirtyBottom, row);
+	}
+	void RenderMineCounter(int32_t unflaggedMines) override
+	{
+		auto text = L"残り地雷数: " + std::to_wstring(unflaggedMines);
+		if (m_Viewport.GetSize() != m_BoardSize)
+			text += L"  表示位置: " + std::to_wstring(m_Viewport.X) + L", " + std::to_wstring(m_Viewport.Y);
+		if (!m_Message.empty())
+			text += L"  " + m_Message;
+		if (text == m_StatusText)
+			return;
+		const ConsoleCoordinate position(0, static_cast<int16_t>(m_Viewport.Height));
+		m_Output.FillOutput(L' ', m_BufferWidth, position);
+		m_Output.WriteOutput(text, position);
+		Instrumentation::GetInstance().Add(InstrumentationCounter::ConsoleCalls, 2);
+		m_StatusText = std::move(text);
+	}
+	void EndFrame() override
+	{
+		if (m_DirtyTop > m_DirtyBottom)
+		{
+			m_Output.Flush();
+			Instrumentation::GetInstance().Add(InstrumentationCounter::ConsoleCalls);
+			return;
+		}
+		// 変化した行の範囲を画面バッファの幅で折り返す一続きの文字列と属性列に組み立て、それぞれ 1 回で書き込む
+		m_FrameText.clear();
+		m_FrameAttributes.clear();
+		for (uint32_t y = m_DirtyTop; y <= m_DirtyBottom; y++)
+		{
+			for (size_t index = static_cast<size_t>(y) * m_Viewport.Width, end = index + m_Viewport.Width; index < end; index++)
+			{
+				// 半角空白のみ 2 文字で 1 セル分の幅を占める
+				if (m_Characters[index] == L' ')
+					m_FrameText.append(2, L' ');
+				else
+					m_FrameText.push_back(m_Characters[index]);
+				m_FrameAttributes.insert(m_FrameAttributes.end(), 2, m_Attributes[index]);
+			}
+			m_FrameText.append(m_BufferWidth - m_Viewport.Width * 2, L' ');
+			m_FrameAttributes.insert(m_FrameAttributes.end(), m_BufferWidth - m_Viewport.Width * 2, { DefaultForeground, DefaultBackground });
+		}
+		const ConsoleCoordinate position(0, static_cast<int16_t>(m_DirtyTop));
+		m_Output.WriteOutput(m_FrameText, position);
+		m_Output.WriteOutput(m_FrameAttributes.cbegin(), m_FrameAttributes.cend(), position);
+		m_DirtyTop = m_Viewport.Height;
+		m_DirtyBottom = 0;
+		m_Output.Flush();
+		Instrumentation::GetInstance().Add(InstrumentationCounter::ConsoleCalls, 3);
+	}
+
+private:
+	TOutputConsole& m_Output;
+	Size m_BoardSize;
+	Rect m_Viewport;
+	uint32_t m_BufferWidth;
+	std::vector<wchar_t> m_Characters;
+	std::vector<ConsoleCharacterAttribute> m_Attributes;
+	uint32_t m_DirtyTop;
+	uint32_t m_DirtyBottom;
+	std::wstring m_StatusText;
+	std::wstring m_Message;
+	std::wstring m_FrameText;
+	std::vector<ConsoleCharacterAttribute> m_FrameAttributes;
+
+	void Compose(size_t index, wchar_t character, ConsoleColor foreground)
+	{
+		m_Characters[index] = character;
+		m_Attributes[index] = { foreground, DefaultBackground };
+	}
+
+	constexpr static ConsoleColor GetColor(int value)
+	{
+		switch (value)
+		{
+		case 1:  return ConsoleColor::Blue;
+		case 2:  return ConsoleColor::Green;
+		case 4:  return ConsoleColor::Navy;
+		case 5:  return ConsoleColor::Maroon;
+		case 6:  return ConsoleColor::Teal;
+		default: return ConsoleColor::Red;
+		}
+	}
+};
@@ -0,0 +1,188 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <string>
+
+// 計測する処理の区間
+enum class InstrumentationTimer
+{
+	ReadInput,
+	HandleEvent,
+	GetProgress,
+	Render,
+	Count,
+};
+
+enum class InstrumentationCounter
+{
+	EventsHandled,
+	EventsCoalesced,
+	CellsOpened,
+	FramesDrawn,
+	ConsoleCalls,
+	Count,
+};
+
+// ナノ秒単位の時間を 2 倍ごとに 16 分割した区間で数える（誤差は 1/16 以内）
+class LatencyHistogram
+{
+public:
+	constexpr LatencyHistogram() : m_Buckets(), m_Count(0), m_Total(0), m_Maximum(0) { }
+
+	constexpr uint64_t GetCount() const { return m_Count; }
+	constexpr uint64_t GetTotal() const { return m_Total; }
+	constexpr uint64_t GetMaximum() const { return m_Maximum; }
+
+	constexpr void Add(uint64_t nanoseconds)
+	{
+		m_Buckets[GetBucketIndex(nanoseconds)]++;
+		m_Count++;
+		m_Total += nanoseconds;
+		m_Maximum = std::max(m_Maximum, nanoseconds);
+	}
+	constexpr void Merge(const LatencyHistogram& other)
+	{
+		for (size_t i = 0; i < BucketCount; i++)
+			m_Buckets[i] += other.m_Buckets[i];
+		m_Count += other.m_Count;
+		m_Total += other.m_Total;
+		m_Maximum = std::max(m_Maximum, other.m_Maximum);
+	}
+	// percentile は 0 から 100 までの値で、該当する区間の上限を返す
+	constexpr uint64_t GetPercentile(double percentile) const
+	{
+		if (m_Count == 0)
+			return 0;
+		const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(static_cast<double>(m_Count) * percentile / 100 + 0.5));
+		uint64_t seen = 0;
+		for (size_t i = 0; i < BucketCount; i++)
+		{
+			seen += m_Buckets[i];
+			if (seen >= rank)
+				return std::min(GetBucketUpperBound(i), m_Maximum);
+		}
+		return m_Maximum;
+	}
+
+private:
+	constexpr static uint32_t SubBucketBits = 4;
+	constexpr static uint64_t SubBucketCount = uint64_t(1) << SubBucketBits;
+	constexpr static size_t BucketCount = (64 - SubBucketBits + 1) * SubBucketCount;
+
+	std::array<uint64_t, BucketCount> m_Buckets;
+	uint64_t m_Count;
+	uint64_t m_Total;
+	uint64_t m_Maximum;
+
+	constexpr static size_t GetBucketIndex(uint64_t value)
+	{
+		if (value < SubBucketCount)
+			return static_cast<size_t>(value);
+		const auto exponent = static_cast<uint32_t>(std::bit_width(value)) - 1;
+		return static_cast<size_t>((exponent - SubBucketBits + 1) * SubBucketCount + ((value >> (exponent - SubBucketBits)) - SubBucketCount));
+	}
+	constexpr static uint64_t GetBucketUpperBound(size_t index)
+	{
+		if (index < SubBucketCount)
+			return index;
+		const auto exponent = static_cast<uint32_t>(index / SubBucketCount) + SubBucketBits - 1;
+		const auto lower = (SubBucketCount + index % SubBucketCount) << (exponent - SubBucketBits);
+		return lower + ((uint64_t(1) << (exponent - SubBucketBits)) - 1);
+	}
+};
+
+// 処理時間と回数を集計する。無効な間は時刻を読まず、記録も行わない
+class Instrumentation
+{
+public:
+	Instrumentation(const Instrumentation&) = delete;
+	Instrumentation& operator =(const Instrumentation&) = delete;
+
+	static Instrumentation& GetInstance()
+	{
+		static Instrumentation instance;
+		return instance;
+	}
+
+	bool IsEnabled() const { return m_IsEnabled; }
+	void SetEnabled(bool enabled) { m_IsEnabled = enabled; }
+	bool HasRecords() const { return m_HasRecords; }
+
+	void Record(InstrumentationTimer timer, std::chrono::nanoseconds duration)
+	{
+		if (!m_IsEnabled)
+			return;
+		m_Histograms[static_cast<size_t>(timer)].Add(static_cast<uint64_t>(std::max<std::chrono::nanoseconds::rep>(duration.count(), 0)));
+		m_HasRecords = true;
+	}
+	void Add(InstrumentationCounter counter, uint64_t value = 1)
+	{
+		if (!m_IsEnabled)
+			return;
+		m_Counters[static_cast<size_t>(counter)] += value;
+		m_HasRecords = true;
+	}
+
+	// 集計結果を表形式のテキストでファイルに書き出す（時間はマイクロ秒単位、合計のみミリ秒単位）
+	bool Dump(const std::string& path) const
+	{
+		const auto file = std::fopen(path.c_str(), "w");
+		if (!file)
+			return false;
+		std::fprintf(file, "%-16s %10s %12s %12s %12s %12s %12s\n", "timer", "count", "p50_us", "p95_us", "p99_us", "max_us", "total_ms");
+		for (size_t i = 0; i < m_Histograms.size(); i++)
+		{
+			const auto& histogram = m_Histograms[i];
+			std::fprintf(file, "%-16s %10llu %12.3f %12.3f %12.3f %12.3f %12.3f\n", TimerNames[i],
+				static_cast<unsigned long long>(histogram.GetCount()),
+				histogram.GetPercentile(50) / 1e3, histogram.GetPercentile(95) / 1e3, histogram.GetPercentile(99) / 1e3,
+				histogram.GetMaximum() / 1e3, histogram.GetTotal() / 1e6);
+		}
+		std::fprintf(file, "\n%-16s %10s\n", "counter", "value");
+		for (size_t i = 0; i < m_Counters.size(); i++)
+			std::fprintf(file, "%-16s %10llu\n", CounterNames[i], static_cast<unsigned long long>(m_Counters[i]));
+		return std::fclose(file) == 0;
+	}
+
+private:
+	constexpr static const char* TimerNames[] = { "read_input", "handle_event", "get_progress", "render" };
+	constexpr static const char* CounterNames[] = { "events_handled", "events_coalesced", "cells_opened", "frames_drawn", "console_calls" };
+	static_assert(std::size(TimerNames) == static_cast<size_t>(InstrumentationTimer::Count));
+	static_assert(std::size(CounterNames) == static_cast<size_t>(InstrumentationCounter::Count));
+
+	bool m_IsEnabled;
+	bool m_HasRecords;
+	std::array<LatencyHistogram, static_cast<size_t>(InstrumentationTimer::Count)> m_Histograms;
+	std::array<uint64_t, static_cast<size_t>(InstrumentationCounter::Count)> m_Counters;
+
+	Instrumentation() : m_IsEnabled(false), m_HasRecords(false), m_Histograms(), m_Counters() { }
+};
+
+// スコープを抜けるまでの時間を記録する
+class ScopedInstrumentationTimer
+{
+public:
+	explicit ScopedInstrumentationTimer(InstrumentationTimer timer) : m_Timer(timer), m_IsEnabled(Instrumentation::GetInstance().IsEnabled())
+	{
+		if (m_IsEnabled)
+			m_StartTime = std::chrono::steady_clock::now();
+	}
+	ScopedInstrumentationTimer(const ScopedInstrumentationTimer&) = delete;
+	ScopedInstrumentationTimer& operator =(const ScopedInstrumentationTimer&) = delete;
+	~ScopedInstrumentationTimer()
+	{
+		if (m_IsEnabled)
+			Instrumentation::GetInstance().Record(m_Timer, std::chrono::steady_clock::now() - m_StartTime);
+	}
+
+private:
+	InstrumentationTimer m_Timer;
+	bool m_IsEnabled;
+	std::chrono::steady_clock::time_point m_StartTime;
+};
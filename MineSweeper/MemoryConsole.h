@@ -0,0 +1,171 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Console.h"
+#include "TerminalScreen.h"
+
+// OutputConsole と同じ操作を、実際のコンソールの代わりにメモリ上の文字と属性の格子に対して行う
+class MemoryOutputConsole
+{
+public:
+	explicit MemoryOutputConsole(ConsoleSize size) :
+		m_Screen(size),
+		m_Mode(ConsoleOutputModes::EnableProcessedOutput | ConsoleOutputModes::EnableWrapAtEolOutput),
+		m_CursorSize(25),
+		m_Font(),
+		m_WindowBounds(0, 0, size.Width - 1, size.Height - 1),
+		m_NumberOfCalls(0),
+		m_NumberOfFlushes(0) { }
+	MemoryOutputConsole(const MemoryOutputConsole&) = delete;
+	MemoryOutputConsole& operator=(const MemoryOutputConsole&) = delete;
+
+	ConsoleOutputModes GetMode() const { return m_Mode; }
+	void SetMode(ConsoleOutputModes value) { m_Mode = value; }
+	ConsoleSize GetScreenBufferSize() const { return m_Screen.GetSize(); }
+	void SetScreenBufferSize(ConsoleSize value) { m_Screen.Resize(value); }
+	ConsoleCoordinate GetCursorPosition() const { return m_Screen.GetCursorPosition(); }
+	void SetCursorPosition(ConsoleCoordinate position) { m_Screen.SetCursorPosition(position); }
+	uint32_t GetCursorSize() const { return m_CursorSize; }
+	void SetCursorSize(uint32_t value) { m_CursorSize = value; }
+	bool GetIsCursorVisible() const { return m_Screen.GetIsCursorVisible(); }
+	void SetIsCursorVisible(bool value) { m_Screen.SetIsCursorVisible(value); }
+	// ウィンドウとフォントは設定した値を保持するだけにする
+	ConsoleRect GetWindowBounds() const { return m_WindowBounds; }
+	void SetWindowBounds(bool absolute, const ConsoleRect& value)
+	{
+		if (absolute)
+			m_WindowBounds = value;
+		else
+			m_WindowBounds = ConsoleRect(m_WindowBounds.Left + value.Left, m_WindowBounds.Top + value.Top, m_WindowBounds.Right + value.Right, m_WindowBounds.Bottom + value.Bottom);
+	}
+	ConsoleSize GetMaximumWindowSize() const { return GetScreenBufferSize(); }
+	ConsoleCharacterAttribute GetTextAttribute() const { return m_Screen.GetTextAttribute(); }
+	void SetTextAttribute(ConsoleCharacterAttribute value) { m_Screen.SetTextAttribute(value); }
+	ConsoleFontInfo GetCurrentFont(bool) const { return m_Font; }
+	void SetCurrentFont(bool, const ConsoleFontInfo& value) { m_Font = value; }
+
+	uint32_t FillOutput(wchar_t character, uint32_t length, ConsoleCoordinate coord)
+	{
+		m_NumberOfCalls++;
+		return m_Screen.FillOutput(character, length, coord);
+	}
+	uint32_t FillOutput(ConsoleCharacterAttribute attribute, uint32_t length, ConsoleCoordinate coord)
+	{
+		m_NumberOfCalls++;
+		return m_Screen.FillOutput(attribute, length, coord);
+	}
+	uint32_t WriteOutput(std::wstring_view characters, ConsoleCoordinate coord)
+	{
+		m_NumberOfCalls++;
+		return m_Screen.WriteOutput(characters, coord);
+	}
+	template <typename InputIterator> uint32_t WriteOutput(InputIterator attributesBegin, InputIterator attributesEnd, ConsoleCoordinate coord)
+	{
+		m_NumberOfCalls++;
+		return m_Screen.WriteOutput(attributesBegin, attributesEnd, coord);
+	}
+	uint32_t Write(std::wstring_view text)
+	{
+		m_NumberOfCalls++;
+		return m_Screen.Write(text);
+	}
+	void Flush() { m_NumberOfFlushes++; }
+	void InvalidateCache() { }
+
+	// 書き込まれた内容を調べるために使う
+	const TerminalScreen& GetScreen() const { return m_Screen; }
+	// Flush 以外の書き込みの呼び出し回数と Flush の呼び出し回数
+	uint64_t GetNumberOfCalls() const { return m_NumberOfCalls; }
+	uint64_t GetNumberOfFlushes() const { return m_NumberOfFlushes; }
+
+private:
+	TerminalScreen m_Screen;
+	ConsoleOutputModes m_Mode;
+	uint32_t m_CursorSize;
+	ConsoleFontInfo m_Font;
+	ConsoleRect m_WindowBounds;
+	uint64_t m_NumberOfCalls;
+	uint64_t m_NumberOfFlushes;
+};
+
+// InputConsole と同じ操作で、あらかじめ追加したイベントと行を順に返す
+// イベントは追加したまとまりごとに 1 回の ReadInput で読める数として報告し、実際のコンソールで溜まっていた入力を再現する
+class MemoryInputConsole
+{
+public:
+	MemoryInputConsole() : m_Mode(ConsoleInputModes::EnableProcessedInput | ConsoleInputModes::EnableLineInput | ConsoleInputModes::EnableEchoInput) { }
+	MemoryInputConsole(const MemoryInputConsole&) = delete;
+	MemoryInputConsole& operator=(const MemoryInputConsole&) = delete;
+
+	void AddInput(std::vector<EventRecord> events)
+	{
+		if (!events.empty())
+			m_Batches.push_back(std::move(events));
+	}
+	void AddInput(EventRecord event) { m_Batches.push_back({ std::move(event) }); }
+	void AddLine(std::wstring line) { m_Lines.push_back(std::move(line)); }
+	bool IsEmpty() const { return m_Batches.empty() && m_Lines.empty(); }
+
+	ConsoleInputModes GetMode() const { return m_Mode; }
+	void SetMode(ConsoleInputModes value) { m_Mode = value; }
+	uint32_t GetNumberOfInputEvents() const { return m_Batches.empty() ? 0 : static_cast<uint32_t>(m_Batches.front().size()); }
+	std::optional<EventRecord> PeekInput() const
+	{
+		std::optional<EventRecord> value;
+		if (!m_Batches.empty())
+			value = m_Batches.front().front();
+		return value;
+	}
+	std::vector<EventRecord> PeekInput(uint32_t length) const
+	{
+		if (m_Batches.empty())
+			return {};
+		const auto& events = m_Batches.front();
+		return std::vector<EventRecord>(events.cbegin(), events.cbegin() + std::min<size_t>(length, events.size()));
+	}
+	// 実際のコンソールのように入力を待つことはできないため、イベントが残っていない場合は例外を送出する
+	EventRecord ReadInput() { return std::move(ReadInput(1).front()); }
+	std::vector<EventRecord> ReadInput(uint32_t length)
+	{
+		std::vector<EventRecord> records;
+		ReadInput(length, records);
+		return records;
+	}
+	// records の中身を読んだイベントで置き換える。records の容量は使い回す
+	void ReadInput(uint32_t length, std::vector<EventRecord>& records)
+	{
+		records.clear();
+		if (length == 0)
+			return;
+		if (m_Batches.empty())
+			throw std::out_of_range("No scripted input events remain.");
+		auto& events = m_Batches.front();
+		const auto count = std::min<size_t>(length, events.size());
+		records.assign(std::make_move_iterator(events.begin()), std::make_move_iterator(events.begin() + count));
+		events.erase(events.begin(), events.begin() + count);
+		if (events.empty())
+			m_Batches.pop_front();
+	}
+	std::wstring Read()
+	{
+		if (m_Lines.empty())
+			throw std::out_of_range("No scripted input lines remain.");
+		auto line = std::move(m_Lines.front());
+		m_Lines.pop_front();
+		return line;
+	}
+	void FlushInputBuffer() { m_Batches.clear(); }
+
+	static uint32_t GetNumberOfMouseButtons() { return 3; }
+
+private:
+	ConsoleInputModes m_Mode;
+	std::deque<std::vector<EventRecord>> m_Batches;
+	std::deque<std::wstring> m_Lines;
+};
@@ -0,0 +1,229 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <optional>
+#include <variant>
+#include <vector>
+#include "Console.h"
+#include "ConsoleGameRenderer.h"
+#include "Game.h"
+#include "GameRecord.h"
+#include "GameSnapshot.h"
+#include "Instrumentation.h"
+#include "NoGuessGenerator.h"
+
+constexpr Size MaximumViewportSize(60, 40);
+constexpr int32_t WheelScrollAmount = 3;
+
+constexpr Size GetViewportSize(const Size& boardSize) { return Size(std::min(boardSize.Width, MaximumViewportSize.Width), std::min(boardSize.Height, MaximumViewportSize.Height)); }
+
+// 入力を読み込んでから、それによる変化を描画し終えるまでの時間
+struct InputLatency
+{
+	InputLatency() : Frames(0), Events(0), CoalescedEvents(0), Total(0), Maximum(0) { }
+
+	uint64_t Frames;
+	uint64_t Events;
+	uint64_t CoalescedEvents;
+	std::chrono::nanoseconds Total;
+	std::chrono::nanoseconds Maximum;
+
+	void Add(std::chrono::nanoseconds value)
+	{
+		Frames++;
+		Total += value;
+		Maximum = std::max(Maximum, value);
+	}
+};
+
+constexpr bool IsSameMouseMove(const EventRecord& left, const EventRecord& right)
+{
+	const auto leftMouse = std::get_if<MouseEventRecord>(&left);
+	const auto rightMouse = std::get_if<MouseEventRecord>(&right);
+	return leftMouse && rightMouse && leftMouse->Kind == MouseEventKind::Moved && rightMouse->Kind == MouseEventKind::Moved && leftMouse->ButtonState == rightMouse->ButtonState;
+}
+
+// 入力と出力には実際のコンソールのほか、MemoryInputConsole と MemoryOutputConsole を使って画面なしで実行できる
+// snapshotPath を指定すると、[S] でゲームの状態をそこに保存する（GameSnapshot::Load で読み込んで続きから遊べる）
+template <typename TInputConsole, typename TOutputConsole> bool PlayGame(Game& game, bool noGuess, GameRecord& record, InputLatency& latency, TInputConsole& input, TOutputConsole& output, const std::filesystem::path& snapshotPath = std::filesystem::path())
+{
+	auto& instrumentation = Instrumentation::GetInstance();
+	const auto startTime = std::chrono::steady_clock::now();
+	// 取り消した操作は記録から除き、やり直したときに戻す
+	game.SetIsHistoryEnabled(true);
+	std::vector<GameAction> undoneActions;
+	// 盤面を変化させなかった操作は記録せず、記録の末尾と取り消す操作を一致させる
+	const auto addAction = [&](GameActionKind kind, const Point& loc, size_t historyPosition)
+	{
+		if (game.GetHistoryPosition() == historyPosition)
+			return;
+		undoneActions.clear();
+		record.AddAction(GameAction(kind, loc, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime)));
+	};
+	ConsoleGameRenderer renderer(output, game.GetSize(), GetViewportSize(game.GetSize()));
+	game.SetViewport(renderer.GetViewport());
+	std::optional<MouseButtonState> prevButtonState;
+	const auto handleEvent = [&](const EventRecord& eventRecord)
+	{
+		if (std::holds_alternative<BufferEventRecord>(eventRecord))
+		{
+			// 画面バッファの大きさが変わると保持しているカーソルやウィンドウの状態が古くなる
+			output.InvalidateCache();
+			return;
+		}
+		if (const auto keyEvent = std::get_if<KeyEventRecord>(&eventRecord))
+		{
+			// 矢印キーで表示範囲を移動し、[Z] で操作を取り消し、[Y] でやり直し、[S] で保存する
+			if (!keyEvent->IsKeyDown)
+				return;
+			Vector delta;
+			switch (keyEvent->VirtualKeyCode)
+			{
+			case 'I':
+				// 計測の有効・無効を切り替える
+				instrumentation.SetEnabled(!instrumentation.IsEnabled());
+				return;
+			case 'Z':
+				if (game.Undo())
+				{
+					// 地雷の配置は取り消されないので、配置を決めた最初の Open が記録から除かれても同じ盤面を再生できるよう、配置そのものを記録する
+					if (record.GetMineIndices().empty() && game.HasPlacedMines())
+						record.SetMineIndices(game);
+					undoneActions.push_back(record.GetActions().back());
+					record.RemoveLastAction();
+				}
+				return;
+			case 'Y':
+				if (game.Redo())
+				{
+					record.AddAction(undoneActions.back());
+					undoneActions.pop_back();
+				}
+				return;
+			case 'S':
+				if (snapshotPath.empty())
+					return;
+				try
+				{
+					GameSnapshot::Save(game, snapshotPath);
+					renderer.SetMessage(L"保存しました");
+				}
+				catch (const std::exception&)
+				{
+					renderer.SetMessage(L"保存できませんでした");
+				}
+				// 表示を更新させる
+				game.InvalidateAll();
+				return;
+			case VK_LEFT : delta = Vector(-1,  0); break;
+			case VK_RIGHT: delta = Vector( 1,  0); break;
+			case VK_UP   : delta = Vector( 0, -1); break;
+			case VK_DOWN : delta = Vector( 0,  1); break;
+			default: return;
+			}
+			if (renderer.Scroll(delta))
+				game.SetViewport(renderer.GetViewport());
+			return;
+		}
+		const auto ev = std::get_if<MouseEventRecord>(&eventRecord);
+		if (!ev) return;
+		// ホイールで表示範囲を移動する
+		if (ev->Kind == MouseEventKind::VerticallyWheeled || ev->Kind == MouseEventKind::HorizontallyWheeled)
+		{
+			const int32_t amount = ev->Delta > 0 ? -WheelScrollAmount : WheelScrollAmount;
+			if (renderer.Scroll(ev->Kind == MouseEventKind::VerticallyWheeled ? Vector(0, amount) : Vector(-amount, 0)))
+				game.SetViewport(renderer.GetViewport());
+			return;
+		}
+		auto loc = renderer.CoordinateToLocation(ev->Location);
+		if (prevButtonState && loc)
+		{
+			// 左右両ボタン押下→少なくとも左右いずれのボタンが非押下
+			if (prevButtonState->GetLeft() && prevButtonState->GetRight() && (!ev->ButtonState.GetLeft() || !ev->ButtonState.GetRight()))
+			{
+				game.ClearCellOpening();
+				const auto historyPosition = game.GetHistoryPosition();
+				instrumentation.Add(InstrumentationCounter::CellsOpened, game.OpenCellsWithMineIndicator(*loc));
+				addAction(GameActionKind::OpenAround, *loc, historyPosition);
+			}
+			// 左ボタンのみ押下→左右両ボタン非押下
+			if (prevButtonState->GetLeft() && !prevButtonState->GetRight() && !ev->ButtonState.GetLeft() && !ev->ButtonState.GetRight())
+			{
+				// 推測不要の盤面はシードを変えて始め直すので、それまでに立てた旗の操作は記録から除く
+				if (noGuess && !game.HasPlacedMines() && PlaceMinesWithoutGuessing(game, *loc))
+					record.ClearActions();
+				const auto historyPosition = game.GetHistoryPosition();
+				instrumentation.Add(InstrumentationCounter::CellsOpened, game.OpenCell(*loc));
+				addAction(GameActionKind::Open, *loc, historyPosition);
+			}
+			// 右ボタンのみ押下→左右両ボタン非押下
+			if (!prevButtonState->GetLeft() && prevButtonState->GetRight() && !ev->ButtonState.GetLeft() && !ev->ButtonState.GetRight())
+			{
+				const auto historyPosition = game.GetHistoryPosition();
+				game.SwitchFlaggedState(*loc);
+				addAction(GameActionKind::SwitchFlag, *loc, historyPosition);
+			}
+			// 少なくとも左右いずれかのボタンが非押下→左右両ボタン押下
+			if ((!prevButtonState->GetLeft() || !prevButtonState->GetRight()) && ev->ButtonState.GetLeft() && ev->ButtonState.GetRight())
+				game.SetCellOpening(*loc);
+			if (game.IsOpeningAnyCell() && ev->Kind == MouseEventKind::Moved)
+				game.SetCellOpening(*loc);
+		}
+		prevButtonState = ev->ButtonState;
+	};
+	std::optional<std::chrono::steady_clock::time_point> batchTime;
+	// 入力のたびに確保しないよう、読んだイベントを入れる領域はループの外で 1 つだけ持って使い回す
+	std::vector<EventRecord> events;
+	while (true)
+	{
+		if (game.ShouldRender())
+		{
+			{
+				ScopedInstrumentationTimer timer(InstrumentationTimer::Render);
+				game.Render(renderer);
+			}
+			instrumentation.Add(InstrumentationCounter::FramesDrawn);
+			if (batchTime)
+				latency.Add(std::chrono::steady_clock::now() - *batchTime);
+			batchTime = std::nullopt;
+			GameProgress progress;
+			{
+				ScopedInstrumentationTimer timer(InstrumentationTimer::GetProgress);
+				progress = game.GetProgress();
+			}
+			switch (progress)
+			{
+			case GameProgress::InProgress: break;
+			case GameProgress::Failed    : return false;
+			case GameProgress::Completed : return true;
+			}
+		}
+		// 溜まっているイベントをまとめて読み、すべて処理してから 1 回だけ描画する
+		// 入力を待つ時間は計測に含めないよう、既に溜まっているイベントを読むときだけ計測する
+		if (const auto pending = input.GetNumberOfInputEvents(); pending > 0)
+		{
+			ScopedInstrumentationTimer timer(InstrumentationTimer::ReadInput);
+			input.ReadInput(pending, events);
+		}
+		else
+			input.ReadInput(1, events);
+		batchTime = std::chrono::steady_clock::now();
+		latency.Events += events.size();
+		for (size_t i = 0; i < events.size(); i++)
+		{
+			// 同じボタンの状態で続く移動イベントは最後の位置だけを処理する
+			if (i + 1 < events.size() && IsSameMouseMove(events[i], events[i + 1]))
+			{
+				latency.CoalescedEvents++;
+				instrumentation.Add(InstrumentationCounter::EventsCoalesced);
+				continue;
+			}
+			ScopedInstrumentationTimer timer(InstrumentationTimer::HandleEvent);
+			handleEvent(events[i]);
+			instrumentation.Add(InstrumentationCounter::EventsHandled);
+		}
+	}
+}
@@ -0,0 +1,601 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#include "Console.h"
+#include "TerminalScreen.h"
+#include "Utility.h"
+
+// 端末からの入力で生成する仮想キーコード（値は Win32 と同じ）
+constexpr uint16_t VK_BACK   = 0x08;
+constexpr uint16_t VK_TAB    = 0x09;
+constexpr uint16_t VK_RETURN = 0x0D;
+constexpr uint16_t VK_ESCAPE = 0x1B;
+constexpr uint16_t VK_SPACE  = 0x20;
+constexpr uint16_t VK_PRIOR  = 0x21;
+constexpr uint16_t VK_NEXT   = 0x22;
+constexpr uint16_t VK_END    = 0x23;
+constexpr uint16_t VK_HOME   = 0x24;
+constexpr uint16_t VK_LEFT   = 0x25;
+constexpr uint16_t VK_UP     = 0x26;
+constexpr uint16_t VK_RIGHT  = 0x27;
+constexpr uint16_t VK_DOWN   = 0x28;
+constexpr uint16_t VK_INSERT = 0x2D;
+constexpr uint16_t VK_DELETE = 0x2E;
+
+// エスケープシーケンスを含む入力のバイト列をイベントに変換する
+class TerminalInputParser
+{
+public:
+	TerminalInputParser() : m_ButtonState(0) { }
+
+	bool HasPendingInput() const { return !m_Pending.empty(); }
+	void Clear() { m_Pending.clear(); }
+	// complete が true の場合、途中で途切れたシーケンスを待たずに単独のキー入力として扱う
+	void Parse(std::string_view input, bool complete, std::deque<EventRecord>& events)
+	{
+		m_Pending.append(input);
+		size_t position = 0;
+		while (position < m_Pending.size())
+		{
+			auto length = ParseOne(std::string_view(m_Pending).substr(position), events);
+			if (length == 0)
+			{
+				if (!complete)
+					break;
+				if (m_Pending[position] == '\x1b')
+					events.emplace_back(CreateKeyEvent(VK_ESCAPE, L'\x1b', ConsoleControlKeyStates::None));
+				length = 1;
+			}
+			position += length;
+		}
+		m_Pending.erase(0, position);
+	}
+
+private:
+	// ボタンごとの押下状態（Win32 と同じく左 = 1, 右 = 2, 中央 = 4）
+	uint16_t m_ButtonState;
+	std::string m_Pending;
+
+	// 解釈したバイト数を返し、シーケンスが途中で途切れている場合は 0 を返す
+	size_t ParseOne(std::string_view input, std::deque<EventRecord>& events)
+	{
+		const auto lead = static_cast<unsigned char>(input[0]);
+		if (lead == 0x1B)
+		{
+			if (input.size() < 2)
+				return 0;
+			if (input[1] == '[')
+				return ParseControlSequence(input, events);
+			if (input[1] == 'O')
+			{
+				if (input.size() < 3)
+					return 0;
+				if (const auto key = GetCursorKey(input[2]))
+					events.emplace_back(CreateKeyEvent(*key, L'\0', ConsoleControlKeyStates::EnhancedKey));
+				return 3;
+			}
+			events.emplace_back(CreateKeyEvent(VK_ESCAPE, L'\x1b', ConsoleControlKeyStates::None));
+			return 1;
+		}
+		if (lead < 0x80)
+		{
+			events.emplace_back(CreateCharacterEvent(static_cast<wchar_t>(lead)));
+			return 1;
+		}
+		const size_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+		if (input.size() < length)
+			return 0;
+		char32_t character = length == 4 ? lead & 0x07 : length == 3 ? lead & 0x0F : lead & 0x1F;
+		for (size_t i = 1; i < length; i++)
+			character = character << 6 | (static_cast<unsigned char>(input[i]) & 0x3F);
+		if (length > 1)
+			events.emplace_back(CreateCharacterEvent(static_cast<wchar_t>(character)));
+		return length;
+	}
+	size_t ParseControlSequence(std::string_view input, std::deque<EventRecord>& events)
+	{
+		// ESC [ に続くパラメーター (0x30-0x3F) と中間 (0x20-0x2F) のバイトの後に、終端 (0x40-0x7E) のバイトが来る
+		size_t end = 2;
+		while (end < input.size() && static_cast<unsigned char>(input[end]) >= 0x20 && static_cast<unsigned char>(input[end]) <= 0x3F)
+			end++;
+		if (end >= input.size())
+			return 0;
+		const auto final = input[end];
+		const auto parameters = input.substr(2, end - 2);
+		if (!parameters.empty() && parameters[0] == '<' && (final == 'M' || final == 'm'))
+		{
+			ParseMouse(parameters.substr(1), final == 'M', events);
+			return end + 1;
+		}
+		const auto values = ParseParameters(parameters);
+		const auto modifiers = values.size() >= 2 ? GetControlKeyState(values[1] - 1) : ConsoleControlKeyStates::None;
+		if (const auto key = GetCursorKey(final))
+			events.emplace_back(CreateKeyEvent(*key, L'\0', modifiers | ConsoleControlKeyStates::EnhancedKey));
+		else if (final == '~' && !values.empty())
+		{
+			std::optional<uint16_t> key;
+			switch (values[0])
+			{
+			case 1: case 7: key = VK_HOME  ; break;
+			case 2        : key = VK_INSERT; break;
+			case 3        : key = VK_DELETE; break;
+			case 4: case 8: key = VK_END   ; break;
+			case 5        : key = VK_PRIOR ; break;
+			case 6        : key = VK_NEXT  ; break;
+			}
+			if (key)
+				events.emplace_back(CreateKeyEvent(*key, L'\0', modifiers | ConsoleControlKeyStates::EnhancedKey));
+		}
+		return end + 1;
+	}
+	// xterm の SGR 形式 (ESC [ < ボタン ; 桁 ; 行 M/m) のマウス入力
+	void ParseMouse(std::string_view parameters, bool pressed, std::deque<EventRecord>& events)
+	{
+		const auto values = ParseParameters(parameters);
+		if (values.size() < 3)
+			return;
+		const auto code = values[0];
+		MouseEventRecord record;
+		record.Location = ConsoleCoordinate(static_cast<int16_t>(values[1] - 1), static_cast<int16_t>(values[2] - 1));
+		record.ControlKeyState = GetControlKeyState(code >> 2 & 7);
+		const auto button = code & 3;
+		if (code & 64)
+		{
+			// 64: 上, 65: 下, 66: 左, 67: 右
+			record.Kind = button < 2 ? MouseEventKind::VerticallyWheeled : MouseEventKind::HorizontallyWheeled;
+			record.Delta = button == 0 || button == 3 ? 120 : -120;
+		}
+		else if (code & 32)
+			record.Kind = MouseEventKind::Moved;
+		else
+		{
+			const uint16_t mask = button == 0 ? 1 : button == 1 ? 4 : button == 2 ? 2 : 0;
+			if (pressed)
+				m_ButtonState |= mask;
+			else
+				m_ButtonState &= ~mask;
+		}
+		record.ButtonState = MouseButtonState(m_ButtonState);
+		events.emplace_back(record);
+	}
+
+	static std::vector<int> ParseParameters(std::string_view parameters)
+	{
+		std::vector<int> values(1, 0);
+		for (const auto c : parameters)
+		{
+			if (c == ';')
+				values.push_back(0);
+			else if (c >= '0' && c <= '9')
+				values.back() = values.back() * 10 + (c - '0');
+		}
+		return values;
+	}
+	// 修飾キーのビット (1: Shift, 2: Alt, 4: Ctrl)
+	constexpr static ConsoleControlKeyStates GetControlKeyState(int modifiers)
+	{
+		auto state = ConsoleControlKeyStates::None;
+		if (modifiers & 1) state |= ConsoleControlKeyStates::Shift;
+		if (modifiers & 2) state |= ConsoleControlKeyStates::LeftAlt;
+		if (modifiers & 4) state |= ConsoleControlKeyStates::LeftCtrl;
+		return state;
+	}
+	constexpr static std::optional<uint16_t> GetCursorKey(char final)
+	{
+		switch (final)
+		{
+		case 'A': return VK_UP;
+		case 'B': return VK_DOWN;
+		case 'C': return VK_RIGHT;
+		case 'D': return VK_LEFT;
+		case 'H': return VK_HOME;
+		case 'F': return VK_END;
+		default: return std::nullopt;
+		}
+	}
+	constexpr static KeyEventRecord CreateKeyEvent(uint16_t virtualKeyCode, wchar_t character, ConsoleControlKeyStates controlKeyState)
+	{
+		KeyEventRecord record;
+		record.IsKeyDown = true;
+		record.RepeatCount = 1;
+		record.VirtualKeyCode = virtualKeyCode;
+		record.Char = character;
+		record.ControlKeyState = controlKeyState;
+		return record;
+	}
+	constexpr static KeyEventRecord CreateCharacterEvent(wchar_t character)
+	{
+		if (character >= L'a' && character <= L'z')
+			return CreateKeyEvent(static_cast<uint16_t>(character - L'a' + L'A'), character, ConsoleControlKeyStates::None);
+		if (character >= L'A' && character <= L'Z')
+			return CreateKeyEvent(static_cast<uint16_t>(character), character, ConsoleControlKeyStates::Shift);
+		if ((character >= L'0' && character <= L'9') || character == L' ')
+			return CreateKeyEvent(static_cast<uint16_t>(character), character, ConsoleControlKeyStates::None);
+		switch (character)
+		{
+		case L'\r': case L'\n': return CreateKeyEvent(VK_RETURN, L'\r', ConsoleControlKeyStates::None);
+		case L'\t'            : return CreateKeyEvent(VK_TAB, L'\t', ConsoleControlKeyStates::None);
+		case L'\b': case 0x7F : return CreateKeyEvent(VK_BACK, L'\b', ConsoleControlKeyStates::None);
+		}
+		if ((character >= 0x01 && character <= 0x1A))
+			return CreateKeyEvent(static_cast<uint16_t>(character - 0x01 + L'A'), character, ConsoleControlKeyStates::LeftCtrl);
+		return CreateKeyEvent(0, character, ConsoleControlKeyStates::None);
+	}
+};
+
+// 標準入出力につながった端末。Win32 のコンソールと同じくプロセスで 1 つだけ存在し、終了時に元の状態に戻す
+class Terminal
+{
+public:
+	Terminal(const Terminal&) = delete;
+	Terminal& operator=(const Terminal&) = delete;
+
+	static Terminal& GetInstance()
+	{
+		static Terminal terminal;
+		return terminal;
+	}
+
+	TerminalScreen& GetScreen() { return m_Screen; }
+	ConsoleInputModes GetInputMode() const { return m_InputMode; }
+	void SetInputMode(ConsoleInputModes value)
+	{
+		m_InputMode = value;
+		if (!m_IsRaw)
+			return;
+		const bool raw = *m_IsRaw;
+		m_IsRaw = std::nullopt;
+		ApplyInputMode(raw);
+	}
+	ConsoleOutputModes GetOutputMode() const { return m_OutputMode; }
+	void SetOutputMode(ConsoleOutputModes value) { m_OutputMode = value; }
+	ConsoleFontInfo& GetFont() { return m_Font; }
+	uint32_t GetCursorSize() const { return m_CursorSize; }
+	void SetCursorSize(uint32_t value) { m_CursorSize = value; }
+
+	// 画面の変化をまとめて 1 回の書き込みで端末に送る
+	void Flush()
+	{
+		m_Screen.Render(m_Output);
+		WriteAll(m_Output);
+		m_Output.clear();
+	}
+
+	// 待たずに読める入力をすべてイベントに変換し、溜まっているイベントの数を返す
+	size_t PollInput()
+	{
+		ApplyInputMode(true);
+		CheckResize();
+		while (WaitReadable(0))
+			ReadAvailable();
+		return m_Events.size();
+	}
+	// 少なくとも 1 つのイベントが溜まるまで待つ
+	void WaitInput()
+	{
+		ApplyInputMode(true);
+		while (true)
+		{
+			CheckResize();
+			if (!m_Events.empty())
+				return;
+			Flush();
+			if (WaitReadable(-1))
+				ReadAvailable();
+		}
+	}
+	std::deque<EventRecord>& GetEvents() { return m_Events; }
+	void DiscardInput()
+	{
+		ThrowIfNegative(tcflush(STDIN_FILENO, TCIFLUSH));
+		m_Parser.Clear();
+		m_Events.clear();
+	}
+	// 行単位の入力を 1 行読む（端末がエコーバックした分は画面の内容にも反映する）
+	std::wstring ReadLine()
+	{
+		Flush();
+		ApplyInputMode(false);
+		std::string line;
+		while (line.empty() || line.back() != '\n')
+		{
+			char buffer[256];
+			const auto length = read(STDIN_FILENO, buffer, sizeof(buffer));
+			if (length < 0 && errno == EINTR)
+				continue;
+			if (ThrowIfNegative(length) == 0)
+				throw std::runtime_error("The terminal input has been closed.");
+			line.append(buffer, static_cast<size_t>(length));
+		}
+		std::deque<EventRecord> events;
+		TerminalInputParser().Parse(line, true, events);
+		std::wstring text;
+		for (const auto& event : events)
+		{
+			if (const auto key = std::get_if<KeyEventRecord>(&event); key && key->Char != L'\0' && key->Char != L'\r')
+				text.push_back(key->Char);
+		}
+		if ((m_InputMode & ConsoleInputModes::EnableEchoInput) != ConsoleInputModes::Default)
+		{
+			m_Screen.Write(text);
+			m_Screen.Write(L"\n");
+			m_Screen.InvalidateAll();
+		}
+		return text + L'\n';
+	}
+
+private:
+	// 修飾キーなしの Esc と、後続のバイトが遅れて届いたエスケープシーケンスを区別するための待ち時間
+	constexpr static int EscapeTimeout = 10;
+
+	inline static termios s_InitialAttributes;
+	inline static std::atomic<bool> s_IsResized;
+	inline static std::terminate_handler s_TerminateHandler;
+
+	TerminalScreen m_Screen;
+	TerminalInputParser m_Parser;
+	std::deque<EventRecord> m_Events;
+	std::string m_Output;
+	ConsoleInputModes m_InputMode;
+	ConsoleOutputModes m_OutputMode;
+	ConsoleFontInfo m_Font;
+	uint32_t m_CursorSize;
+	std::optional<bool> m_IsRaw;
+	bool m_IsMouseEnabled;
+
+	Terminal() :
+		m_Screen(QuerySize()),
+		m_InputMode(ConsoleInputModes::EnableProcessedInput | ConsoleInputModes::EnableLineInput | ConsoleInputModes::EnableEchoInput),
+		m_OutputMode(ConsoleOutputModes::EnableProcessedOutput | ConsoleOutputModes::EnableWrapAtEolOutput),
+		m_CursorSize(25),
+		m_IsMouseEnabled(false)
+	{
+		ThrowIfNegative(tcgetattr(STDIN_FILENO, &s_InitialAttributes));
+		struct sigaction action = {};
+		action.sa_handler = [](int) { s_IsResized = true; };
+		sigemptyset(&action.sa_mask);
+		ThrowIfNegative(sigaction(SIGWINCH, &action, nullptr));
+		action.sa_handler = [](int signal)
+		{
+			Restore();
+			std::signal(signal, SIG_DFL);
+			std::raise(signal);
+		};
+		for (const auto signal : { SIGINT, SIGTERM, SIGHUP, SIGQUIT })
+			ThrowIfNegative(sigaction(signal, &action, nullptr));
+		s_TerminateHandler = std::set_terminate([]
+		{
+			Restore();
+			if (s_TerminateHandler)
+				s_TerminateHandler();
+			std::abort();
+		});
+		// 代替画面に切り替えて、元の画面の内容を終了時に戻す
+		WriteAll("\x1b[?1049h\x1b[H\x1b[2J");
+	}
+	~Terminal()
+	{
+		try
+		{
+			Flush();
+		}
+		catch (...)
+		{
+		}
+		Restore();
+	}
+
+	// シグナルハンドラーからも呼び出すため、非同期シグナル安全な関数のみを使う
+	static void Restore() noexcept
+	{
+		constexpr char sequence[] = "\x1b[0m\x1b[?25h\x1b[?1006l\x1b[?1002l\x1b[?1049l";
+		static_cast<void>(write(STDOUT_FILENO, sequence, sizeof(sequence) - 1));
+		tcsetattr(STDIN_FILENO, TCSANOW, &s_InitialAttributes);
+	}
+	static ConsoleSize QuerySize()
+	{
+		winsize size = {};
+		if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) < 0 || size.ws_col == 0 || size.ws_row == 0)
+			return ConsoleSize(80, 24);
+		return ConsoleSize(static_cast<int16_t>(size.ws_col), static_cast<int16_t>(size.ws_row));
+	}
+	static void WriteAll(std::string_view data)
+	{
+		while (!data.empty())
+		{
+			const auto length = write(STDOUT_FILENO, data.data(), data.size());
+			if (length < 0 && errno == EINTR)
+				continue;
+			data.remove_prefix(static_cast<size_t>(ThrowIfNegative(length)));
+		}
+	}
+	static bool WaitReadable(int timeout)
+	{
+		pollfd fd = { STDIN_FILENO, POLLIN, 0 };
+		const auto result = poll(&fd, 1, timeout);
+		if (result < 0 && errno == EINTR)
+			return false;
+		return ThrowIfNegative(result) > 0;
+	}
+
+	// raw が true ならキー入力を 1 つずつエコーバックせずに受け取り、マウス入力を有効にする
+	void ApplyInputMode(bool raw)
+	{
+		const bool mouse = raw && (m_InputMode & ConsoleInputModes::EnableMouseInput) != ConsoleInputModes::Default;
+		if (m_IsRaw != raw)
+		{
+			auto attributes = s_InitialAttributes;
+			if (raw)
+			{
+				attributes.c_lflag &= ~(ICANON | ECHO | IEXTEN);
+				attributes.c_iflag &= ~(IXON | ICRNL | INLCR | IGNCR);
+				attributes.c_cc[VMIN] = 1;
+				attributes.c_cc[VTIME] = 0;
+			}
+			else
+			{
+				attributes.c_lflag |= ICANON;
+				if ((m_InputMode & ConsoleInputModes::EnableEchoInput) != ConsoleInputModes::Default)
+					attributes.c_lflag |= ECHO;
+				else
+					attributes.c_lflag &= ~ECHO;
+				// Ctrl+D で読み込みが終わらないようにする
+				attributes.c_cc[VEOF] = _POSIX_VDISABLE;
+			}
+			if ((m_InputMode & ConsoleInputModes::EnableProcessedInput) != ConsoleInputModes::Default)
+				attributes.c_lflag |= ISIG;
+			else
+				attributes.c_lflag &= ~ISIG;
+			ThrowIfNegative(tcsetattr(STDIN_FILENO, TCSANOW, &attributes));
+			m_IsRaw = raw;
+		}
+		if (m_IsMouseEnabled != mouse)
+		{
+			// ボタンを押している間の移動も通知する SGR 形式のマウス入力
+			m_Output += mouse ? "\x1b[?1002h\x1b[?1006h" : "\x1b[?1006l\x1b[?1002l";
+			m_IsMouseEnabled = mouse;
+			Flush();
+		}
+	}
+	void CheckResize()
+	{
+		if (!s_IsResized.exchange(false))
+			return;
+		const auto size = QuerySize();
+		m_Screen.Resize(size);
+		m_Events.emplace_back(BufferEventRecord(size));
+	}
+	void ReadAvailable()
+	{
+		char buffer[1024];
+		const auto length = read(STDIN_FILENO, buffer, sizeof(buffer));
+		if (length < 0 && errno == EINTR)
+			return;
+		if (ThrowIfNegative(length) == 0)
+			throw std::runtime_error("The terminal input has been closed.");
+		m_Parser.Parse(std::string_view(buffer, static_cast<size_t>(length)), false, m_Events);
+		if (m_Parser.HasPendingInput() && !WaitReadable(EscapeTimeout))
+			m_Parser.Parse({}, true, m_Events);
+	}
+};
+
+class ConsoleBase
+{
+public:
+	ConsoleBase(const ConsoleBase&) = delete;
+	ConsoleBase& operator=(const ConsoleBase&) = delete;
+
+protected:
+	ConsoleBase() : m_Terminal(Terminal::GetInstance()) { }
+
+	Terminal& GetTerminal() const { return m_Terminal; }
+
+private:
+	Terminal& m_Terminal;
+};
+
+class OutputConsole : public ConsoleBase
+{
+public:
+	OutputConsole() { }
+
+	ConsoleOutputModes GetMode() const { return GetTerminal().GetOutputMode(); }
+	void SetMode(ConsoleOutputModes value) { GetTerminal().SetOutputMode(value); }
+	ConsoleSize GetScreenBufferSize() const { return GetTerminal().GetScreen().GetSize(); }
+	ConsoleCoordinate GetCursorPosition() const { return GetTerminal().GetScreen().GetCursorPosition(); }
+	void SetCursorPosition(ConsoleCoordinate position) { GetTerminal().GetScreen().SetCursorPosition(position); }
+	uint32_t GetCursorSize() const { return GetTerminal().GetCursorSize(); }
+	void SetCursorSize(uint32_t value) { GetTerminal().SetCursorSize(value); }
+	bool GetIsCursorVisible() const { return GetTerminal().GetScreen().GetIsCursorVisible(); }
+	void SetIsCursorVisible(bool value) { GetTerminal().GetScreen().SetIsCursorVisible(value); }
+	// 端末ではウィンドウと画面バッファは常に同じ大きさで、プログラムから変更できない
+	ConsoleRect GetWindowBounds() const
+	{
+		const auto size = GetScreenBufferSize();
+		return ConsoleRect(0, 0, size.Width - 1, size.Height - 1);
+	}
+	void SetWindowBounds(bool, const ConsoleRect&) { }
+	ConsoleSize GetMaximumWindowSize() const { return GetScreenBufferSize(); }
+	ConsoleCharacterAttribute GetTextAttribute() const { return GetTerminal().GetScreen().GetTextAttribute(); }
+	void SetTextAttribute(ConsoleCharacterAttribute value) { GetTerminal().GetScreen().SetTextAttribute(value); }
+	// 端末のフォントは変更できないため、設定した値を保持するだけにする
+	ConsoleFontInfo GetCurrentFont(bool) const { return GetTerminal().GetFont(); }
+	void SetCurrentFont(bool, const ConsoleFontInfo& value) { GetTerminal().GetFont() = value; }
+
+	uint32_t FillOutput(wchar_t character, uint32_t length, ConsoleCoordinate coord) { return GetTerminal().GetScreen().FillOutput(character, length, coord); }
+	uint32_t FillOutput(ConsoleCharacterAttribute attribute, uint32_t length, ConsoleCoordinate coord) { return GetTerminal().GetScreen().FillOutput(attribute, length, coord); }
+	uint32_t WriteOutput(std::wstring_view characters, ConsoleCoordinate coord) { return GetTerminal().GetScreen().WriteOutput(characters, coord); }
+	template <typename InputIterator> uint32_t WriteOutput(InputIterator attributesBegin, InputIterator attributesEnd, ConsoleCoordinate coord) { return GetTerminal().GetScreen().WriteOutput(attributesBegin, attributesEnd, coord); }
+	uint32_t Write(std::wstring_view text) { return GetTerminal().GetScreen().Write(text); }
+	// 書き込んだ内容は溜めておき、ここか入力を待つ前にまとめて端末に送る
+	void Flush() { GetTerminal().Flush(); }
+
+	// 端末の状態は自身で保持しているため、次回すべてを出力し直すだけにする
+	void InvalidateCache() { GetTerminal().GetScreen().InvalidateAll(); }
+};
+
+class InputConsole : public ConsoleBase
+{
+public:
+	InputConsole() { }
+
+	ConsoleInputModes GetMode() const { return GetTerminal().GetInputMode(); }
+	void SetMode(ConsoleInputModes value) { GetTerminal().SetInputMode(value); }
+	uint32_t GetNumberOfInputEvents() const { return static_cast<uint32_t>(GetTerminal().PollInput()); }
+	std::optional<EventRecord> PeekInput() const
+	{
+		std::optional<EventRecord> value;
+		if (GetTerminal().PollInput() != 0)
+			value = GetTerminal().GetEvents().front();
+		return value;
+	}
+	std::vector<EventRecord> PeekInput(uint32_t length) const
+	{
+		const auto& events = GetTerminal().GetEvents();
+		const auto count = std::min<size_t>(length, GetTerminal().PollInput());
+		return std::vector<EventRecord>(events.cbegin(), events.cbegin() + count);
+	}
+	EventRecord ReadInput()
+	{
+		auto& events = GetTerminal().GetEvents();
+		GetTerminal().WaitInput();
+		auto record = std::move(events.front());
+		events.pop_front();
+		return record;
+	}
+	std::vector<EventRecord> ReadInput(uint32_t length)
+	{
+		std::vector<EventRecord> records;
+		ReadInput(length, records);
+		return records;
+	}
+	// records の中身を読んだイベントで置き換える。records の容量は使い回す
+	void ReadInput(uint32_t length, std::vector<EventRecord>& records)
+	{
+		auto& events = GetTerminal().GetEvents();
+		records.clear();
+		if (length == 0)
+			return;
+		GetTerminal().WaitInput();
+		const auto count = std::min<size_t>(length, events.size());
+		records.assign(std::make_move_iterator(events.begin()), std::make_move_iterator(events.begin() + count));
+		events.erase(events.begin(), events.begin() + count);
+	}
+	std::wstring Read() { return GetTerminal().ReadLine(); }
+	void FlushInputBuffer() { GetTerminal().DiscardInput(); }
+
+	static uint32_t GetNumberOfMouseButtons() { return 3; }
+};
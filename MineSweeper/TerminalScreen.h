@@ -0,0 +1,381 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Console.h"
+
+// 画面の内容を保持し、前回出力した内容との差分だけをエスケープシーケンスに変換する
+class TerminalScreen
+{
+public:
+	explicit TerminalScreen(ConsoleSize size) :
+		m_Size(),
+		m_CursorPosition(),
+		m_IsCursorVisible(true),
+		m_TextAttribute(ConsoleColor::Silver, ConsoleColor::Black),
+		m_DirtyTop(0),
+		m_DirtyBottom(-1),
+		m_ShouldRenderAll(true),
+		m_IsRenderedCursorVisible(true) { Resize(size); }
+
+	ConsoleSize GetSize() const { return m_Size; }
+	// 内容は左上を基準に残し、次回はすべてを出力し直す
+	void Resize(ConsoleSize size)
+	{
+		size = ConsoleSize(std::max<int16_t>(size.Width, 1), std::max<int16_t>(size.Height, 1));
+		std::vector<Cell> cells(static_cast<size_t>(size.Width) * size.Height, Cell(L' ', m_TextAttribute));
+		for (int16_t y = 0; y < std::min(size.Height, m_Size.Height); y++)
+		{
+			const auto source = m_Cells.cbegin() + static_cast<ptrdiff_t>(y) * m_Size.Width;
+			std::copy(source, source + std::min(size.Width, m_Size.Width), cells.begin() + static_cast<ptrdiff_t>(y) * size.Width);
+		}
+		m_Cells = std::move(cells);
+		m_Size = size;
+		m_CursorPosition = ConsoleCoordinate(std::min<int16_t>(m_CursorPosition.X, size.Width - 1), std::min<int16_t>(m_CursorPosition.Y, size.Height - 1));
+		for (size_t index = 0; index < m_Cells.size(); index += m_Size.Width)
+		{
+			// 行末で切れた全角文字の左半分を消す
+			if (m_Cells[index + m_Size.Width - 1].Character != Continuation && GetCharacterWidth(m_Cells[index + m_Size.Width - 1].Character) == 2)
+				m_Cells[index + m_Size.Width - 1].Character = L' ';
+			if (m_Cells[index].Character == Continuation)
+				m_Cells[index].Character = L' ';
+		}
+		InvalidateAll();
+	}
+	ConsoleCoordinate GetCursorPosition() const { return m_CursorPosition; }
+	void SetCursorPosition(ConsoleCoordinate position)
+	{
+		if (position.X < 0 || position.Y < 0 || position.X >= m_Size.Width || position.Y >= m_Size.Height)
+			throw std::out_of_range("The cursor position must be inside the screen.");
+		m_CursorPosition = position;
+	}
+	bool GetIsCursorVisible() const { return m_IsCursorVisible; }
+	void SetIsCursorVisible(bool value) { m_IsCursorVisible = value; }
+	ConsoleCharacterAttribute GetTextAttribute() const { return m_TextAttribute; }
+	void SetTextAttribute(ConsoleCharacterAttribute value) { m_TextAttribute = value; }
+	// 全角文字の右半分のセルでは Continuation を返す
+	wchar_t GetCharacter(ConsoleCoordinate coord) const { return m_Cells.at(GetIndex(coord)).Character; }
+	ConsoleCharacterAttribute GetAttribute(ConsoleCoordinate coord) const { return m_Cells.at(GetIndex(coord)).Attribute; }
+	// 1 行分の文字を全角文字の右半分を除いて返す
+	std::wstring GetText(int16_t y) const
+	{
+		std::wstring text;
+		for (int16_t x = 0; x < m_Size.Width; x++)
+		{
+			if (const auto character = GetCharacter(ConsoleCoordinate(x, y)); character != Continuation)
+				text.push_back(character);
+		}
+		return text;
+	}
+
+	uint32_t FillOutput(wchar_t character, uint32_t length, ConsoleCoordinate coord)
+	{
+		auto index = GetIndex(coord);
+		uint32_t count = 0;
+		for (; count < length && index < m_Cells.size(); count++)
+			index = Put(index, character, std::nullopt);
+		return count;
+	}
+	uint32_t FillOutput(ConsoleCharacterAttribute attribute, uint32_t length, ConsoleCoordinate coord)
+	{
+		const auto begin = GetIndex(coord);
+		const auto end = std::min<size_t>(begin + length, m_Cells.size());
+		for (auto index = begin; index < end; index++)
+			m_Cells[index].Attribute = attribute;
+		MarkDirty(begin, end);
+		return static_cast<uint32_t>(end - begin);
+	}
+	uint32_t WriteOutput(std::wstring_view characters, ConsoleCoordinate coord)
+	{
+		auto index = GetIndex(coord);
+		uint32_t count = 0;
+		for (; count < characters.size() && index < m_Cells.size(); count++)
+			index = Put(index, characters[count], std::nullopt);
+		return count;
+	}
+	template <typename InputIterator> uint32_t WriteOutput(InputIterator attributesBegin, InputIterator attributesEnd, ConsoleCoordinate coord)
+	{
+		const auto begin = GetIndex(coord);
+		auto index = begin;
+		for (; attributesBegin != attributesEnd && index < m_Cells.size(); ++attributesBegin)
+			m_Cells[index++].Attribute = *attributesBegin;
+		MarkDirty(begin, index);
+		return static_cast<uint32_t>(index - begin);
+	}
+	// カーソル位置に書き込んでカーソルを進め、最下行からはみ出す場合は画面全体を 1 行ずつ上に送る
+	uint32_t Write(std::wstring_view text)
+	{
+		for (const auto character : text)
+		{
+			if (character == L'\n')
+			{
+				NewLine();
+				continue;
+			}
+			if (character == L'\r')
+			{
+				m_CursorPosition.X = 0;
+				continue;
+			}
+			if (character == L'\b')
+			{
+				if (m_CursorPosition.X > 0)
+					m_CursorPosition.X--;
+				continue;
+			}
+			const auto width = static_cast<int16_t>(GetCharacterWidth(character));
+			if (m_CursorPosition.X + width > m_Size.Width)
+				NewLine();
+			Put(GetIndex(m_CursorPosition), character, m_TextAttribute);
+			m_CursorPosition.X += width;
+			if (m_CursorPosition.X >= m_Size.Width)
+				NewLine();
+		}
+		return static_cast<uint32_t>(text.size());
+	}
+	// 端末の実際の状態が分からなくなった場合に呼び出し、次回はすべてを出力し直す
+	void InvalidateAll()
+	{
+		m_ShouldRenderAll = true;
+		m_RenderedCursorPosition = std::nullopt;
+		m_RenderedAttribute = std::nullopt;
+	}
+
+	void Render(std::string& output)
+	{
+		if (m_ShouldRenderAll)
+		{
+			m_Displayed.assign(m_Cells.size(), Cell(Continuation, m_TextAttribute));
+			m_DirtyTop = 0;
+			m_DirtyBottom = m_Size.Height - 1;
+		}
+		if (m_DirtyTop <= m_DirtyBottom)
+		{
+			// 描画中のカーソルのちらつきを抑える
+			output += "\x1b[?25l";
+			m_IsRenderedCursorVisible = false;
+			for (int16_t y = m_DirtyTop; y <= m_DirtyBottom; y++)
+				RenderRow(output, y);
+		}
+		m_DirtyTop = 0;
+		m_DirtyBottom = -1;
+		m_ShouldRenderAll = false;
+		if (m_RenderedCursorPosition != m_CursorPosition)
+		{
+			AppendCursorPosition(output, m_CursorPosition.X, m_CursorPosition.Y);
+			m_RenderedCursorPosition = m_CursorPosition;
+		}
+		// エコーバックされる入力の色を合わせておく
+		AppendAttribute(output, m_TextAttribute);
+		if (m_IsRenderedCursorVisible != m_IsCursorVisible)
+		{
+			output += m_IsCursorVisible ? "\x1b[?25h" : "\x1b[?25l";
+			m_IsRenderedCursorVisible = m_IsCursorVisible;
+		}
+	}
+
+	// Win32 のコンソールと同じく、全角文字と東アジアで全角として扱われる記号は 2 桁を占める
+	constexpr static uint32_t GetCharacterWidth(wchar_t character) { return IsWide(character) || IsAmbiguous(character) ? 2 : 1; }
+
+	static void AppendUtf8(std::string& output, char32_t character)
+	{
+		if (character < 0x80)
+			output += static_cast<char>(character);
+		else if (character < 0x800)
+		{
+			output += static_cast<char>(0xC0 | character >> 6);
+			output += static_cast<char>(0x80 | (character & 0x3F));
+		}
+		else if (character < 0x10000)
+		{
+			output += static_cast<char>(0xE0 | character >> 12);
+			output += static_cast<char>(0x80 | (character >> 6 & 0x3F));
+			output += static_cast<char>(0x80 | (character & 0x3F));
+		}
+		else
+		{
+			output += static_cast<char>(0xF0 | character >> 18);
+			output += static_cast<char>(0x80 | (character >> 12 & 0x3F));
+			output += static_cast<char>(0x80 | (character >> 6 & 0x3F));
+			output += static_cast<char>(0x80 | (character & 0x3F));
+		}
+	}
+
+	// 全角文字の右半分のセル
+	constexpr static wchar_t Continuation = L'\0';
+
+private:
+	struct Cell
+	{
+		constexpr Cell(wchar_t character, ConsoleCharacterAttribute attribute) : Character(character), Attribute(attribute) { }
+
+		wchar_t Character;
+		ConsoleCharacterAttribute Attribute;
+
+		constexpr bool operator ==(const Cell& right) const { return Character == right.Character && Attribute.Foreground == right.Attribute.Foreground && Attribute.Background == right.Attribute.Background; }
+		constexpr bool operator !=(const Cell& right) const { return !(*this == right); }
+	};
+
+	ConsoleSize m_Size;
+	std::vector<Cell> m_Cells;
+	std::vector<Cell> m_Displayed;
+	ConsoleCoordinate m_CursorPosition;
+	bool m_IsCursorVisible;
+	ConsoleCharacterAttribute m_TextAttribute;
+	int16_t m_DirtyTop;
+	int16_t m_DirtyBottom;
+	bool m_ShouldRenderAll;
+	std::optional<ConsoleCoordinate> m_RenderedCursorPosition;
+	std::optional<ConsoleCharacterAttribute> m_RenderedAttribute;
+	bool m_IsRenderedCursorVisible;
+
+	size_t GetIndex(ConsoleCoordinate coord) const
+	{
+		if (coord.X < 0 || coord.Y < 0 || coord.X >= m_Size.Width || coord.Y >= m_Size.Height)
+			return m_Cells.size();
+		return static_cast<size_t>(coord.Y) * m_Size.Width + coord.X;
+	}
+	void MarkDirty(size_t begin, size_t end)
+	{
+		if (begin >= end)
+			return;
+		m_DirtyTop = std::min(m_DirtyTop, static_cast<int16_t>(begin / m_Size.Width));
+		m_DirtyBottom = std::max(m_DirtyBottom, static_cast<int16_t>((end - 1) / m_Size.Width));
+	}
+	// 文字の片側だけを上書きする場合は、残る側を空白にする
+	void Detach(size_t index)
+	{
+		if (m_Cells[index].Character == Continuation)
+			m_Cells[index - 1].Character = L' ';
+		else if (index + 1 < m_Cells.size() && m_Cells[index + 1].Character == Continuation)
+			m_Cells[index + 1].Character = L' ';
+	}
+	// 1 文字を書き込み、次に書き込むセルの位置を返す（行末に入らない全角文字は次の行に送る）
+	size_t Put(size_t index, wchar_t character, std::optional<ConsoleCharacterAttribute> attribute)
+	{
+		const auto begin = index;
+		if (GetCharacterWidth(character) == 2 && index % m_Size.Width == static_cast<size_t>(m_Size.Width - 1))
+		{
+			Detach(index);
+			m_Cells[index++].Character = L' ';
+			if (index >= m_Cells.size())
+			{
+				MarkDirty(begin, index);
+				return index;
+			}
+		}
+		const auto width = GetCharacterWidth(character);
+		for (size_t i = 0; i < width; i++)
+			Detach(index + i);
+		for (size_t i = 0; i < width; i++)
+		{
+			m_Cells[index + i].Character = i == 0 ? (character < L' ' ? L' ' : character) : Continuation;
+			if (attribute)
+				m_Cells[index + i].Attribute = *attribute;
+		}
+		index += width;
+		MarkDirty(begin > 0 ? begin - 1 : begin, std::min(index + 1, m_Cells.size()));
+		return index;
+	}
+	void NewLine()
+	{
+		m_CursorPosition.X = 0;
+		if (m_CursorPosition.Y + 1 < m_Size.Height)
+		{
+			m_CursorPosition.Y++;
+			return;
+		}
+		std::move(m_Cells.begin() + m_Size.Width, m_Cells.end(), m_Cells.begin());
+		std::fill(m_Cells.end() - m_Size.Width, m_Cells.end(), Cell(L' ', m_TextAttribute));
+		m_ShouldRenderAll = true;
+	}
+	void RenderRow(std::string& output, int16_t y)
+	{
+		const auto row = static_cast<size_t>(y) * m_Size.Width;
+		int16_t first = 0;
+		while (first < m_Size.Width && m_Cells[row + first] == m_Displayed[row + first])
+			first++;
+		if (first == m_Size.Width)
+			return;
+		int16_t last = m_Size.Width - 1;
+		while (m_Cells[row + last] == m_Displayed[row + last])
+			last--;
+		if (m_Cells[row + first].Character == Continuation)
+			first--;
+		if (last + 1 < m_Size.Width && m_Cells[row + last + 1].Character == Continuation)
+			last++;
+		AppendCursorPosition(output, first, y);
+		for (int16_t x = first; x <= last; x++)
+		{
+			const auto& cell = m_Cells[row + x];
+			if (cell.Character == Continuation)
+				continue;
+			AppendAttribute(output, cell.Attribute);
+			// 端末によって幅が 1 桁にも 2 桁にもなる文字は、先に 2 桁分を消去してから書き、後で桁を明示してずれを防ぐ
+			const bool ambiguous = IsAmbiguous(cell.Character);
+			if (ambiguous)
+				output += "\x1b[2X";
+			AppendUtf8(output, static_cast<char32_t>(cell.Character));
+			if (ambiguous)
+			{
+				output += "\x1b[";
+				output += std::to_string(x + 3);
+				output += 'G';
+			}
+		}
+		std::copy(m_Cells.cbegin() + row + first, m_Cells.cbegin() + row + last + 1, m_Displayed.begin() + row + first);
+		m_RenderedCursorPosition = std::nullopt;
+	}
+	static void AppendCursorPosition(std::string& output, int16_t x, int16_t y)
+	{
+		output += "\x1b[";
+		output += std::to_string(y + 1);
+		output += ';';
+		output += std::to_string(x + 1);
+		output += 'H';
+	}
+	void AppendAttribute(std::string& output, ConsoleCharacterAttribute attribute)
+	{
+		if (m_RenderedAttribute && m_RenderedAttribute->Foreground == attribute.Foreground && m_RenderedAttribute->Background == attribute.Background)
+			return;
+		output += "\x1b[";
+		output += std::to_string(ToAnsiColor(attribute.Foreground, 30, 90));
+		output += ';';
+		output += std::to_string(ToAnsiColor(attribute.Background, 40, 100));
+		output += 'm';
+		m_RenderedAttribute = attribute;
+	}
+	// Win32 の色は青、緑、赤、明るさのビットの順に、ANSI の色は赤、緑、青の順に並ぶ
+	constexpr static int ToAnsiColor(ConsoleColor color, int normal, int bright)
+	{
+		const auto value = static_cast<uint8_t>(color);
+		return ((value & 8) ? bright : normal) + ((value & 1) << 2 | (value & 2) | (value & 4) >> 2);
+	}
+	constexpr static bool IsWide(wchar_t character)
+	{
+		return
+			(character >= 0x1100 && character <= 0x115F) ||
+			(character >= 0x2E80 && character <= 0x303E) ||
+			(character >= 0x3041 && character <= 0x33FF) ||
+			(character >= 0x3400 && character <= 0x4DBF) ||
+			(character >= 0x4E00 && character <= 0x9FFF) ||
+			(character >= 0xA000 && character <= 0xA4CF) ||
+			(character >= 0xAC00 && character <= 0xD7A3) ||
+			(character >= 0xF900 && character <= 0xFAFF) ||
+			(character >= 0xFE30 && character <= 0xFE4F) ||
+			(character >= 0xFF00 && character <= 0xFF60) ||
+			(character >= 0xFFE0 && character <= 0xFFE6);
+	}
+	constexpr static bool IsAmbiguous(wchar_t character)
+	{
+		return
+			(character >= 0x2460 && character <= 0x24FF) ||
+			(character >= 0x2500 && character <= 0x257F) ||
+			(character >= 0x25A0 && character <= 0x25FF) ||
+			(character >= 0x2605 && character <= 0x2606);
+	}
+};
+
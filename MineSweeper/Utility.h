@@ -4,6 +4,7 @@
 #include <sstream>
 #include <iomanip>
 
+#ifdef _WIN32
 #ifndef NOMINMAX
 #define NOMINMAX
 #endif
@@ -44,3 +45,15 @@ template <typename T> inline typename std::remove_reference<T>::type ThrowIfFail
 	if (!value) ThrowLastException();
 	return std::forward<T>(value);
 }
+#else
+#include <cerrno>
+#include <system_error>
+
+inline void ThrowLastException() { throw std::system_error(errno, std::generic_category()); }
+
+template <typename T> inline T ThrowIfNegative(T value)
+{
+	if (value < 0) ThrowLastException();
+	return value;
+}
+#endif
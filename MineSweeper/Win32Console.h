@@ -0,0 +1,346 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+#include "Console.h"
+#include "Utility.h"
+
+static_assert(static_cast<uint32_t>(ConsoleOutputModes::EnableProcessedOutput) == ENABLE_PROCESSED_OUTPUT);
+static_assert(static_cast<uint32_t>(ConsoleOutputModes::EnableWrapAtEolOutput) == ENABLE_WRAP_AT_EOL_OUTPUT);
+static_assert(static_cast<uint32_t>(ConsoleOutputModes::EnableVirtualTerminalProcessing) == ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+static_assert(static_cast<uint32_t>(ConsoleOutputModes::DisableNewLineAutoReturn) == DISABLE_NEWLINE_AUTO_RETURN);
+static_assert(static_cast<uint32_t>(ConsoleOutputModes::EnableLvbGridWorldWide) == ENABLE_LVB_GRID_WORLDWIDE);
+static_assert(static_cast<uint32_t>(ConsoleInputModes::EnableProcessedInput) == ENABLE_PROCESSED_INPUT);
+static_assert(static_cast<uint32_t>(ConsoleInputModes::EnableLineInput) == ENABLE_LINE_INPUT);
+static_assert(static_cast<uint32_t>(ConsoleInputModes::EnableEchoInput) == ENABLE_ECHO_INPUT);
+static_assert(static_cast<uint32_t>(ConsoleInputModes::EnableWindowInput) == ENABLE_WINDOW_INPUT);
+static_assert(static_cast<uint32_t>(ConsoleInputModes::EnableMouseInput) == ENABLE_MOUSE_INPUT);
+static_assert(static_cast<uint32_t>(ConsoleInputModes::EnableInsertMode) == ENABLE_INSERT_MODE);
+static_assert(static_cast<uint32_t>(ConsoleInputModes::EnableQuickEditMode) == ENABLE_QUICK_EDIT_MODE);
+static_assert(static_cast<uint32_t>(ConsoleInputModes::EnableExtendedFlags) == ENABLE_EXTENDED_FLAGS);
+static_assert(static_cast<uint32_t>(ConsoleInputModes::EnableAutoPosition) == ENABLE_AUTO_POSITION);
+static_assert(static_cast<uint32_t>(ConsoleInputModes::EnableVirtualTerminalInput) == ENABLE_VIRTUAL_TERMINAL_INPUT);
+static_assert(static_cast<uint32_t>(ConsoleControlKeyStates::RightAlt) == RIGHT_ALT_PRESSED);
+static_assert(static_cast<uint32_t>(ConsoleControlKeyStates::LeftAlt) == LEFT_ALT_PRESSED);
+static_assert(static_cast<uint32_t>(ConsoleControlKeyStates::RightCtrl) == RIGHT_CTRL_PRESSED);
+static_assert(static_cast<uint32_t>(ConsoleControlKeyStates::LeftCtrl) == LEFT_CTRL_PRESSED);
+static_assert(static_cast<uint32_t>(ConsoleControlKeyStates::Shift) == SHIFT_PRESSED);
+static_assert(static_cast<uint32_t>(ConsoleControlKeyStates::NumLock) == NUMLOCK_ON);
+static_assert(static_cast<uint32_t>(ConsoleControlKeyStates::ScrollLock) == SCROLLLOCK_ON);
+static_assert(static_cast<uint32_t>(ConsoleControlKeyStates::CapsLock) == CAPSLOCK_ON);
+static_assert(static_cast<uint32_t>(ConsoleControlKeyStates::EnhancedKey) == ENHANCED_KEY);
+static_assert(static_cast<uint32_t>(ConsoleControlKeyStates::DbcsChar) == NLS_DBCSCHAR);
+static_assert(static_cast<uint32_t>(ConsoleControlKeyStates::AlphaNumeric) == NLS_ALPHANUMERIC);
+static_assert(static_cast<uint32_t>(ConsoleControlKeyStates::Katakana) == NLS_KATAKANA);
+static_assert(static_cast<uint32_t>(ConsoleControlKeyStates::Hiragana) == NLS_HIRAGANA);
+static_assert(static_cast<uint32_t>(ConsoleControlKeyStates::Roman) == NLS_ROMAN);
+static_assert(static_cast<uint32_t>(ConsoleControlKeyStates::ImeConversion) == NLS_IME_CONVERSION);
+static_assert(static_cast<uint32_t>(ConsoleControlKeyStates::ImeDisable) == NLS_IME_DISABLE);
+static_assert(static_cast<uint32_t>(MouseEventKind::Moved) == MOUSE_MOVED);
+static_assert(static_cast<uint32_t>(MouseEventKind::DoubleClicked) == DOUBLE_CLICK);
+static_assert(static_cast<uint32_t>(MouseEventKind::VerticallyWheeled) == MOUSE_WHEELED);
+static_assert(static_cast<uint32_t>(MouseEventKind::HorizontallyWheeled) == MOUSE_HWHEELED);
+
+constexpr inline EventRecord CreateEventRecord(const INPUT_RECORD& record)
+{
+	EventRecord eventRecord;
+	switch (record.EventType)
+	{
+	case KEY_EVENT               : eventRecord.emplace<KeyEventRecord   >(record.Event.KeyEvent             ); break;
+	case MOUSE_EVENT             : eventRecord.emplace<MouseEventRecord >(record.Event.MouseEvent           ); break;
+	case WINDOW_BUFFER_SIZE_EVENT: eventRecord.emplace<BufferEventRecord>(record.Event.WindowBufferSizeEvent); break;
+	case MENU_EVENT              : eventRecord.emplace<MenuEventRecord  >(record.Event.MenuEvent            ); break;
+	case FOCUS_EVENT             : eventRecord.emplace<FocusEventRecord >(record.Event.FocusEvent           ); break;
+	default: _ASSERT_EXPR(false, "Unreachable"); break;
+	}
+	return eventRecord;
+}
+
+class ConsoleBase abstract
+{
+public:
+	ConsoleBase(HANDLE handle) : m_Handle(handle) { }
+	ConsoleBase(DWORD kind) : m_Handle(GetHandle(kind)) { }
+	ConsoleBase(const ConsoleBase&) = delete;
+	ConsoleBase(ConsoleBase&&) = default;
+	ConsoleBase& operator=(const ConsoleBase&) = delete;
+	ConsoleBase& operator=(ConsoleBase&&) = default;
+
+protected:
+	HANDLE GetHandle() const { return m_Handle; }
+	uint32_t GetModeCore() const
+	{
+		DWORD mode;
+		ThrowIfFailed(GetConsoleMode(m_Handle, &mode));
+		return mode;
+	}
+	void SetModeCore(uint32_t value) { ThrowIfFailed(SetConsoleMode(m_Handle, value)); }
+
+private:
+	HANDLE m_Handle;
+
+	static HANDLE GetHandle(DWORD kind)
+	{
+		auto handle = GetStdHandle(kind);
+		if (handle == INVALID_HANDLE_VALUE)
+			ThrowLastException();
+		return handle;
+	}
+};
+
+class OutputConsole : public ConsoleBase
+{
+public:
+	OutputConsole() : ConsoleBase(STD_OUTPUT_HANDLE), m_IsCursorPositionStale(false) { }
+
+	ConsoleOutputModes GetMode() const { return static_cast<ConsoleOutputModes>(GetModeCore()); }
+	void SetMode(ConsoleOutputModes value) { return SetModeCore(static_cast<uint32_t>(value)); }
+	ConsoleSize GetScreenBufferSize() const { return ConsoleSize(GetScreenBufferInfo().dwSize); }
+	void SetScreenBufferSize(ConsoleSize value)
+	{
+		ThrowIfFailed(SetConsoleScreenBufferSize(GetHandle(), static_cast<COORD>(value)));
+		// ウィンドウの大きさも変わることがあるため、次に問い合わせるときに取得し直す
+		InvalidateCache();
+	}
+	ConsoleCoordinate GetCursorPosition() const { return ConsoleCoordinate(GetScreenBufferInfo(true).dwCursorPosition); }
+	void SetCursorPosition(ConsoleCoordinate position)
+	{
+		ThrowIfFailed(SetConsoleCursorPosition(GetHandle(), static_cast<COORD>(position)));
+		// カーソルを表示するためにウィンドウが移動することがある
+		m_IsCursorPositionStale = true;
+	}
+	uint32_t GetCursorSize() const { return GetCursorInfo().dwSize; }
+	void SetCursorSize(uint32_t value)
+	{
+		auto info = GetCursorInfo();
+		if (info.dwSize == value)
+			return;
+		info.dwSize = value;
+		SetCursorInfo(info);
+	}
+	bool GetIsCursorVisible() const { return GetCursorInfo().bVisible; }
+	void SetIsCursorVisible(bool value)
+	{
+		auto info = GetCursorInfo();
+		if (static_cast<bool>(info.bVisible) == value)
+			return;
+		info.bVisible = value;
+		SetCursorInfo(info);
+	}
+	ConsoleRect GetWindowBounds() const { return ConsoleRect(GetScreenBufferInfo(true).srWindow); }
+	void SetWindowBounds(bool absolute, const ConsoleRect& bounds)
+	{
+		auto rect = static_cast<SMALL_RECT>(bounds);
+		ThrowIfFailed(SetConsoleWindowInfo(GetHandle(), absolute, &rect));
+		InvalidateCache();
+	}
+	ConsoleSize GetMaximumWindowSize() const { return ConsoleSize(GetScreenBufferInfo().dwMaximumWindowSize); }
+	ConsoleCharacterAttribute GetTextAttribute() const { return ConsoleCharacterAttribute(GetScreenBufferInfo().wAttributes); }
+	void SetTextAttribute(ConsoleCharacterAttribute value)
+	{
+		const auto attributes = static_cast<uint16_t>(value);
+		auto& info = GetScreenBufferInfo();
+		if (info.wAttributes == attributes)
+			return;
+		ThrowIfFailed(SetConsoleTextAttribute(GetHandle(), attributes));
+		info.wAttributes = attributes;
+	}
+	ConsoleCharacterAttribute GetPopupAttribute() const { return ConsoleCharacterAttribute(GetScreenBufferInfo().wPopupAttributes); }
+	bool IsFullScreenSupported() const { return GetScreenBufferInfo().bFullscreenSupported; }
+	std::vector<COLORREF> GetColorTable() const
+	{
+		const auto& info = GetScreenBufferInfo();
+		return std::vector<COLORREF>(info.ColorTable, info.ColorTable + sizeof(info.ColorTable) / sizeof(info.ColorTable[0]));
+	}
+	ConsoleFontInfo GetCurrentFont(bool maximumWindow) const
+	{
+		CONSOLE_FONT_INFOEX info{ sizeof(CONSOLE_FONT_INFOEX) };
+		ThrowIfFailed(GetCurrentConsoleFontEx(GetHandle(), maximumWindow, &info));
+		return ConsoleFontInfo(info);
+	}
+	void SetCurrentFont(bool maximumWindow, const ConsoleFontInfo& value)
+	{
+		CONSOLE_FONT_INFOEX info;
+		value.CopyTo(info);
+		ThrowIfFailed(SetCurrentConsoleFontEx(GetHandle(), maximumWindow, &info));
+		// フォントの大きさに合わせてウィンドウの大きさが変わる
+		InvalidateCache();
+	}
+
+	uint32_t FillOutput(WCHAR character, uint32_t length, ConsoleCoordinate coord)
+	{
+		DWORD actualLength;
+		ThrowIfFailed(FillConsoleOutputCharacterW(GetHandle(), character, length, static_cast<COORD>(coord), &actualLength));
+		return actualLength;
+	}
+	uint32_t FillOutput(ConsoleCharacterAttribute attribute, uint32_t length, ConsoleCoordinate coord)
+	{
+		DWORD actualLength;
+		ThrowIfFailed(FillConsoleOutputAttribute(GetHandle(), static_cast<uint16_t>(attribute), length, static_cast<COORD>(coord), &actualLength));
+		return actualLength;
+	}
+	uint32_t WriteOutput(std::wstring_view characters, ConsoleCoordinate coord)
+	{
+		DWORD actualLength;
+		ThrowIfFailed(WriteConsoleOutputCharacterW(GetHandle(), characters.data(), static_cast<DWORD>(characters.size()), static_cast<COORD>(coord), &actualLength));
+		return actualLength;
+	}
+	template <typename InputIterator> uint32_t WriteOutput(InputIterator attributesBegin, InputIterator attributesEnd, ConsoleCoordinate coord)
+	{
+		std::vector<uint16_t> buffer;
+		std::transform(attributesBegin, attributesEnd, std::back_insert_iterator(buffer), [](const ConsoleCharacterAttribute& attr) { return static_cast<uint16_t>(attr); });
+		DWORD actualLength;
+		ThrowIfFailed(WriteConsoleOutputAttribute(GetHandle(), buffer.data(), static_cast<DWORD>(buffer.size()), static_cast<COORD>(coord), &actualLength));
+		return actualLength;
+	}
+	uint32_t Write(std::wstring_view text)
+	{
+		DWORD actualLength;
+		ThrowIfFailed(WriteConsoleW(GetHandle(), text.data(), static_cast<DWORD>(text.size()), &actualLength, nullptr));
+		// 折り返しや全角文字の幅はコンソールが決めるため、移動後のカーソルの位置は次に問い合わせるときに取得する
+		m_IsCursorPositionStale = true;
+		return actualLength;
+	}
+	void Flush() { }
+
+	// このプログラム以外が画面バッファを変更した場合 (BufferEventRecord を受け取った場合など) に呼び出す
+	void InvalidateCache()
+	{
+		m_ScreenBufferInfo.reset();
+		m_CursorInfo.reset();
+		m_IsCursorPositionStale = false;
+	}
+
+private:
+	// 画面バッファを変更するのはこのプログラムだけなので、問い合わせた結果を保持して自身の変更で更新する
+	mutable std::optional<CONSOLE_SCREEN_BUFFER_INFOEX> m_ScreenBufferInfo;
+	mutable std::optional<CONSOLE_CURSOR_INFO> m_CursorInfo;
+	// カーソルの位置とそれに伴うウィンドウの位置が変わった可能性がある
+	mutable bool m_IsCursorPositionStale;
+
+	CONSOLE_SCREEN_BUFFER_INFOEX& GetScreenBufferInfo(bool needsCursorPosition = false) const
+	{
+		if (!m_ScreenBufferInfo || (needsCursorPosition && m_IsCursorPositionStale))
+		{
+			CONSOLE_SCREEN_BUFFER_INFOEX info;
+			info.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+			ThrowIfFailed(GetConsoleScreenBufferInfoEx(GetHandle(), &info));
+			m_ScreenBufferInfo = info;
+			m_IsCursorPositionStale = false;
+		}
+		return *m_ScreenBufferInfo;
+	}
+	const CONSOLE_CURSOR_INFO& GetCursorInfo() const
+	{
+		if (!m_CursorInfo)
+		{
+			CONSOLE_CURSOR_INFO info;
+			ThrowIfFailed(GetConsoleCursorInfo(GetHandle(), &info));
+			m_CursorInfo = info;
+		}
+		return *m_CursorInfo;
+	}
+	void SetCursorInfo(const CONSOLE_CURSOR_INFO& info)
+	{
+		ThrowIfFailed(SetConsoleCursorInfo(GetHandle(), &info));
+		m_CursorInfo = info;
+	}
+};
+
+class InputConsole : public ConsoleBase
+{
+public:
+	InputConsole() : ConsoleBase(STD_INPUT_HANDLE) { }
+
+	ConsoleInputModes GetMode() const { return static_cast<ConsoleInputModes>(GetModeCore()); }
+	void SetMode(ConsoleInputModes value) { return SetModeCore(static_cast<uint32_t>(value)); }
+	uint32_t GetNumberOfInputEvents() const
+	{
+		DWORD numberOfEvents;
+		ThrowIfFailed(GetNumberOfConsoleInputEvents(GetHandle(), &numberOfEvents));
+		return numberOfEvents;
+	}
+	uint32_t PeekInput(INPUT_RECORD* buffer, uint32_t length) const { return PeekReadInput(PeekConsoleInputW, GetHandle(), buffer, length); }
+	std::optional<EventRecord> PeekInput() const
+	{
+		INPUT_RECORD inputRecord;
+		std::optional<EventRecord> value;
+		if (PeekReadInput(PeekConsoleInputW, GetHandle(), &inputRecord, 1) != 0)
+			value = CreateEventRecord(inputRecord);
+		return value;
+	}
+	std::vector<EventRecord> PeekInput(uint32_t length) const { return PeekReadInput(PeekConsoleInputW, GetHandle(), length); }
+	uint32_t ReadInput(INPUT_RECORD* buffer, uint32_t length) { return PeekReadInput(ReadConsoleInputW, GetHandle(), buffer, length); }
+	EventRecord ReadInput()
+	{
+		INPUT_RECORD inputRecord;
+		PeekReadInput(ReadConsoleInputW, GetHandle(), &inputRecord, 1);
+		return CreateEventRecord(inputRecord);
+	}
+	std::vector<EventRecord> ReadInput(uint32_t length) { return PeekReadInput(ReadConsoleInputW, GetHandle(), length); }
+	// records の中身を読んだイベントで置き換える。records と内部のバッファの容量を使い回すため、繰り返し呼んでも確保は起きない
+	void ReadInput(uint32_t length, std::vector<EventRecord>& records)
+	{
+		if (m_InputBuffer.size() < length)
+			m_InputBuffer.resize(length);
+		const auto actualLength = PeekReadInput(ReadConsoleInputW, GetHandle(), m_InputBuffer.data(), length);
+		records.clear();
+		std::transform(m_InputBuffer.cbegin(), m_InputBuffer.cbegin() + actualLength, std::back_inserter(records), CreateEventRecord);
+	}
+	uint32_t Read(WCHAR* buffer, uint32_t length, const std::optional<CONSOLE_READCONSOLE_CONTROL>& control = std::nullopt)
+	{
+		DWORD actualLength;
+		CONSOLE_READCONSOLE_CONTROL* pControl = nullptr;
+		if (control)
+			pControl = const_cast<CONSOLE_READCONSOLE_CONTROL*>(&*control);
+		ThrowIfFailed(ReadConsoleW(GetHandle(), buffer, length, &actualLength, pControl));
+		return actualLength;
+	}
+	std::wstring Read(const std::optional<CONSOLE_READCONSOLE_CONTROL>& control = std::nullopt)
+	{
+		constexpr uint32_t charsToRead = 16;
+		std::wstring buffer;
+		size_t charsReadSoFar = 0;
+		while (true)
+		{
+			buffer.resize(charsReadSoFar + charsToRead);
+			const auto charsRead = Read(buffer.data() + charsReadSoFar, charsToRead, control);
+			charsReadSoFar += charsRead;
+			if (charsRead < charsToRead) break;
+		}
+		buffer.resize(charsReadSoFar);
+		buffer.shrink_to_fit();
+		return std::move(buffer);
+	}
+	void FlushInputBuffer() { ThrowIfFailed(FlushConsoleInputBuffer(GetHandle())); }
+
+	static uint32_t GetNumberOfMouseButtons()
+	{
+		DWORD numberOfMouseButtons;
+		ThrowIfFailed(GetNumberOfConsoleMouseButtons(&numberOfMouseButtons));
+		return numberOfMouseButtons;
+	}
+
+private:
+	using PeekReadFunc = BOOL(WINAPI *)(HANDLE, PINPUT_RECORD, DWORD, LPDWORD);
+
+	static uint32_t PeekReadInput(PeekReadFunc func, HANDLE handle, INPUT_RECORD* buffer, uint32_t length)
+	{
+		DWORD actualLength;
+		ThrowIfFailed(func(handle, buffer, length, &actualLength));
+		return actualLength;
+	}
+	static std::vector<EventRecord> PeekReadInput(PeekReadFunc func, HANDLE handle, uint32_t length)
+	{
+		std::vector<INPUT_RECORD> buffer(length);
+		auto actualLength = PeekReadInput(func, handle, buffer.data(), length);
+		std::vector<EventRecord> records(actualLength);
+		std::transform(buffer.cbegin(), buffer.cbegin() + actualLength, records.begin(), CreateEventRecord);
+		return records;
+	}
+
+	std::vector<INPUT_RECORD> m_InputBuffer;
+};
\ No newline at end of file